@@ -0,0 +1,308 @@
+/******************************************************************************
+ * @details This is a file containing functions regarding the [basis]
+ * 				functions.
+ *
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/04
+ ******************************************************************************/
+#include "basis.hpp"
+#include "common.hpp"
+#include "kernels.hpp"
+#include "quadrature.hpp"
+#include "quadrature_tables.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace basis
+{
+	// Cached storage. Elements up to degree tables::maxDegree on rules up to
+	//  tables::maxNoPoints points are tabulated at compile time; anything
+	//  larger is built on first request under a lock.
+	namespace
+	{
+		using quadrature::tables::maxDegree;
+		using quadrature::tables::maxNoPoints;
+
+		/******************************************************************************
+		 * tabulate
+		 *
+		 * @details 	Fills a_values[(i*a_noRows + a)*n + k] with the ith derivative
+		 * 				of the ath shape function at the kth point, for a=0..p.
+		 *
+		 * @param[in] a_p 		The polynomial degree.
+		 * @param[in] a_noRows 	Rows per derivative in a_values; at least p+1.
+		 * @param[in] a_n 		The number of points.
+		 * @param[in] a_points 	The points.
+		 * @param[in] a_P 		Scratch space for (maxDerivative+1)*(p+1) values.
+		 * @param[out] a_values The tabulated values.
+		 ******************************************************************************/
+		constexpr void tabulate(const int a_p, const int a_noRows, const int a_n, const double a_points[], double a_P[], double a_values[])
+		{
+			for (int k=0; k<a_n; ++k)
+			{
+				double xi = a_points[k];
+				quadrature::tables::legendrePolynomials(a_p, maxDerivative, xi, a_P);
+
+				for (int i=0; i<=maxDerivative; ++i)
+				{
+					const double* P_i = &a_P[i*(a_p+1)];
+					double* row = &a_values[i*a_noRows*a_n];
+
+					// Vertex functions; the points are inside [-1, 1].
+					row[k]       = (i==0)?(1-xi)/2:(i==1)?-double(1)/2:0;
+					if (a_p >= 1)
+						row[a_n + k] = (i==0)?(1+xi)/2:(i==1)? double(1)/2:0;
+
+					for (int a=2; a<=a_p; ++a)
+						row[a*a_n + k] = quadrature::tables::sqrt(double(a-1)-0.5) * (P_i[a] - P_i[a-2]);
+				}
+			}
+		}
+
+		// Shape functions up to degree maxDegree at each tabulated rule; the
+		//  n-point block starts at offset(n).
+		constexpr int offset(const int a_n)
+		{
+			return (maxDerivative+1)*(maxDegree+1)*quadrature::tables::offset(a_n);
+		}
+
+		struct BasisValues
+		{
+			double values[offset(maxNoPoints+1)];
+		};
+
+		constexpr BasisValues make_basisValues()
+		{
+			BasisValues basisValues = {};
+			double P[(maxDerivative+1)*(maxDegree+1)] = {};
+
+			for (int n=1; n<=maxNoPoints; ++n)
+				tabulate(maxDegree, maxDegree+1, n, quadrature::tables::gaussLegendre.points + quadrature::tables::offset(n), P, basisValues.values + offset(n));
+
+			return basisValues;
+		}
+
+		constexpr BasisValues basisValues = make_basisValues();
+
+		// Views of the compile-time values for every degree and rule.
+		struct TabulatedBases
+		{
+			Tabulation tabulations[maxDegree+1][maxNoPoints+1];
+		};
+
+		constexpr TabulatedBases make_tabulatedBases()
+		{
+			TabulatedBases tabulatedBases = {};
+
+			for (int p=0; p<=maxDegree; ++p)
+				for (int n=1; n<=maxNoPoints; ++n)
+				{
+					Tabulation &tabulation = tabulatedBases.tabulations[p][n];
+					tabulation.polynomialDegree = p;
+					tabulation.noPoints         = n;
+
+					for (int i=0; i<=maxDerivative; ++i)
+						tabulation.values[i] = basisValues.values + offset(n) + i*(maxDegree+1)*n;
+				}
+
+			return tabulatedBases;
+		}
+
+		constexpr TabulatedBases tabulatedBases = make_tabulatedBases();
+
+		// Tables built at run time.
+		struct GeneratedBasis
+		{
+			Tabulation          tabulation;
+			std::vector<double> values;
+		};
+
+		std::map<std::tuple<int, int, int>, GeneratedBasis> tabulations;
+		std::mutex                                          tabulationsMutex;
+
+		// Reference element matrices, keyed by family, degree, derivative and
+		//  number of points.
+		std::map<std::tuple<int, int, int, int>, std::vector<double>> referenceMatrices;
+		std::mutex                                                    referenceMatricesMutex;
+	}
+
+	/******************************************************************************
+	 * __basisFunction__
+	 *
+	 * @details 	Evaluates the ith derivative of the nth basis function at x.
+	 * 				The vertex functions are cut off outside [-1, 1]; the
+	 * 				remaining functions are sqrt(n-3/2)*(P_n - P_{n-2}).
+	 *
+	 * @param[in] a_n 		Which basis function to evaluate.
+	 * @param[in] a_i 		Which derivative to evaluate.
+	 * @param[in] a_x 		The point on the reference element.
+	 * @return  			The value of the requested derivative.
+	 ******************************************************************************/
+	double basisFunction(const int &a_n, const int &a_i, const double &a_x)
+	{
+		if (a_n==0 || a_n==1)
+		{
+			if (a_i>=2 || a_x < -1 || 1 < a_x)
+				return 0;
+
+			if (a_i==0)
+				return (a_n==0)?(1-a_x)/2:(1+a_x)/2;
+			else
+				return (a_n==0)?-double(1)/2:double(1)/2;
+		}
+
+		std::vector<double> P((a_i+1)*(a_n+1));
+		quadrature::legendrePolynomials(a_n, a_i, a_x, P.data());
+
+		return sqrt(double(a_n-1)-0.5) * (P[a_i*(a_n+1) + a_n] - P[a_i*(a_n+1) + a_n-2]);
+	}
+
+	/******************************************************************************
+	 * __basisFunction__
+	 *
+	 * @details 	Calculates the ith derivative of the nth basis function.
+	 *
+	 * @param[in] a_n 		Which basis function to return.
+	 * @param[in] a_i 		Which derivative to return.
+	 * @return  			The requested derivative basis function.
+	 ******************************************************************************/
+	f_double basisFunction(const int &a_n, const int &a_i)
+	{
+		return [a_n, a_i](double x) -> double
+		{
+			return basisFunction(a_n, a_i, x);
+		};
+	}
+
+	/******************************************************************************
+	 * __basisFunctions__
+	 *
+	 * @details 	Evaluates the derivatives 0..i of every shape function of a
+	 * 				degree p element at m points in one call. The Legendre
+	 * 				recurrences are run across all points at once by
+	 * 				kernels::legendreBasis, in vectors where the processor has
+	 * 				them.
+	 *
+	 * @param[in] a_p 		The polynomial degree of the element.
+	 * @param[in] a_i 		The highest derivative to evaluate.
+	 * @param[in] a_m 		The number of points.
+	 * @param[in] a_x 		The points on the reference element.
+	 * @param[out] a_values (i+1)*(p+1)*m values; the jth derivative of the ath
+	 * 						 shape function at the kth point is stored at
+	 * 						 a_values[(j*(p+1) + a)*m + k].
+	 ******************************************************************************/
+	void basisFunctions(const int &a_p, const int &a_i, const int &a_m, const double a_x[], double a_values[])
+	{
+		std::vector<double> P((a_i+1)*(a_p+1)*a_m);
+
+		kernels::legendreBasis(a_p, a_i, a_m, a_x, P.data(), a_values);
+	}
+
+	/******************************************************************************
+	 * __get_tabulation__
+	 *
+	 * @details 	Returns the values of the derivatives 0..maxDerivative of the
+	 * 				shape functions of a degree p element at the points of the
+	 * 				n-point rule of the given family. Gauss-Legendre tables for
+	 * 				small degrees and rules come from the compile-time tables;
+	 * 				other tables are built on first request and cached
+	 * 				thereafter.
+	 *
+	 * @param[in] a_p 		The polynomial degree of the element.
+	 * @param[in] a_n 		The number of quadrature points.
+	 * @param[in] a_family 	The family of the quadrature rule.
+	 * @return  			The tabulated shape functions.
+	 ******************************************************************************/
+	const Tabulation& get_tabulation(const int &a_p, const int &a_n, const quadrature::Family &a_family)
+	{
+		if (a_family == quadrature::GaussLegendre && a_p <= maxDegree && a_n <= maxNoPoints)
+			return tabulatedBases.tabulations[a_p][a_n];
+
+		std::lock_guard<std::mutex> lock(tabulationsMutex);
+
+		std::tuple<int, int, int> key(a_family, a_p, a_n);
+		std::map<std::tuple<int, int, int>, GeneratedBasis>::iterator it = tabulations.find(key);
+
+		if (it != tabulations.end())
+			return it->second.tabulation;
+
+		GeneratedBasis &generated = tabulations[key];
+		generated.values.resize((maxDerivative+1)*(a_p+1)*a_n);
+
+		// One sweep of the Legendre recurrences per point gives every function.
+		std::vector<double> P((maxDerivative+1)*(a_p+1));
+		tabulate(a_p, a_p+1, a_n, quadrature::get_rule(a_family, a_n).points, P.data(), generated.values.data());
+
+		Tabulation &tabulation = generated.tabulation;
+		tabulation.polynomialDegree = a_p;
+		tabulation.noPoints         = a_n;
+		for (int i=0; i<=maxDerivative; ++i)
+			tabulation.values[i] = generated.values.data() + i*(a_p+1)*a_n;
+
+		return tabulation;
+	}
+
+	/******************************************************************************
+	 * __get_referenceMatrix__
+	 *
+	 * @details 	Returns the matrix of integrals over the reference element of
+	 * 				the products of the ith derivatives of the shape functions of
+	 * 				a degree p element, using the n-point rule of the given family.
+	 * 				With i=0 this is the reference mass matrix and with i=1 the
+	 * 				reference stiffness matrix; element matrices with constant
+	 * 				coefficients are scaled copies of these. Matrices are built on
+	 * 				first request and cached thereafter.
+	 *
+	 * @param[in] a_p 		The polynomial degree of the element.
+	 * @param[in] a_i 		The derivative of the shape functions.
+	 * @param[in] a_n 		The number of quadrature points.
+	 * @param[in] a_family 	The family of the quadrature rule.
+	 * @return  			(p+1)*(p+1) values, with the entry for shape functions
+	 * 						 a and b at [a*(p+1) + b].
+	 ******************************************************************************/
+	const double* get_referenceMatrix(const int &a_p, const int &a_i, const int &a_n, const quadrature::Family &a_family)
+	{
+		std::lock_guard<std::mutex> lock(referenceMatricesMutex);
+
+		std::tuple<int, int, int, int> key(a_family, a_p, a_i, a_n);
+		std::map<std::tuple<int, int, int, int>, std::vector<double>>::iterator it = referenceMatrices.find(key);
+
+		if (it != referenceMatrices.end())
+			return it->second.data();
+
+		const quadrature::Rule &rule = quadrature::get_rule(a_family, a_n);
+		const Tabulation &tabulation = get_tabulation(a_p, a_n, a_family);
+
+		std::vector<double> &matrix = referenceMatrices[key];
+		matrix.resize((a_p+1)*(a_p+1));
+
+		double largest = 0;
+		for (int a=0; a<=a_p; ++a)
+			for (int b=0; b<=a_p; ++b)
+			{
+				const double* basis1 = tabulation.get_row(a, a_i);
+				const double* basis2 = tabulation.get_row(b, a_i);
+
+				double integral = 0;
+				for (int k=0; k<rule.noPoints; ++k)
+					integral += basis1[k]*basis2[k]*rule.weights[k];
+
+				matrix[a*(a_p+1) + b] = integral;
+				largest = std::max(largest, fabs(integral));
+			}
+
+		// Integrated Legendre polynomials are orthogonal in these products,
+		//  so round-off relative to the largest entry is flushed to exact
+		//  zeros.
+		for (int k=0; k<matrix.size(); ++k)
+			if (fabs(matrix[k]) < 1e-14*largest)
+				matrix[k] = 0;
+
+		return matrix.data();
+	}
+}
\ No newline at end of file
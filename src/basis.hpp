@@ -0,0 +1,46 @@
+/******************************************************************************
+ * @details This is a file containing declarations of the [basis] namespace.
+ *
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/04
+ ******************************************************************************/
+#ifndef NAMESPACE_BASIS
+#define NAMESPACE_BASIS
+
+#include "common.hpp"
+#include "quadrature.hpp"
+#include <vector>
+
+namespace basis
+{
+	// Highest derivative of the shape functions that is tabulated.
+	const int maxDerivative = 3;
+
+	/******************************************************************************
+	 * Tabulation
+	 *
+	 * @details    Values of the derivatives of all shape functions of a degree p
+	 * 				element at every point of an n-point quadrature rule.
+	 * 				get_row(a, i)[k] is the ith derivative of the ath shape
+	 * 				function at the kth quadrature point.
+	 ******************************************************************************/
+	struct Tabulation
+	{
+		int polynomialDegree;
+		int noPoints;
+		const double* values[maxDerivative+1];
+
+		const double* get_row(const int &a_a, const int &a_i) const
+		{
+			return this->values[a_i] + a_a*this->noPoints;
+		}
+	};
+
+	f_double          basisFunction(const int &a_n, const int &a_i);
+	double            basisFunction(const int &a_n, const int &a_i, const double &a_x);
+	void              basisFunctions(const int &a_p, const int &a_i, const int &a_m, const double a_x[], double a_values[]);
+	const Tabulation& get_tabulation(const int &a_p, const int &a_n, const quadrature::Family &a_family = quadrature::GaussLegendre);
+	const double*     get_referenceMatrix(const int &a_p, const int &a_i, const int &a_n, const quadrature::Family &a_family = quadrature::GaussLegendre);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,102 @@
+/******************************************************************************
+ * @details This is a file containing functions regarding the
+ * 				[boundaryConditions] namespace.
+ * 
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/23
+ ******************************************************************************/
+#include "boundaryConditions.hpp"
+#include <vector>
+
+namespace boundaryConditions
+{
+	Condition dirichlet(const double &a_value)
+	{
+		Condition condition;
+		condition.type  = Dirichlet;
+		condition.value = a_value;
+
+		return condition;
+	}
+
+	Condition neumann(const double &a_value)
+	{
+		Condition condition;
+		condition.type  = Neumann;
+		condition.value = a_value;
+
+		return condition;
+	}
+
+	Condition robin(const double &a_coefficient, const double &a_value)
+	{
+		Condition condition;
+		condition.type        = Robin;
+		condition.value       = a_value;
+		condition.coefficient = a_coefficient;
+
+		return condition;
+	}
+
+	/******************************************************************************
+	 * apply
+	 * 
+	 * @details    Applies a condition to an element's contributions as they
+	 * 				are scattered, so the global system never has to be swept
+	 * 				afterwards. A Dirichlet DoF is eliminated: its known value
+	 * 				times its column moves to the right-hand side, and its row
+	 * 				and column become those of the identity, which keeps the
+	 * 				matrix symmetric. The boundary DoF must only belong to this
+	 * 				element, as the end nodes do.
+	 * 
+	 * 				If u is given, the system is instead the Newton one for the
+	 * 				update u - u_next, whose right-hand side is the residual at
+	 * 				u.
+	 * 
+	 * @param[in] a_condition 	The condition.
+	 * @param[in] a_a 			The boundary DoF's index in the element.
+	 * @param[in] a_DoFs 		The element's DoFs.
+	 * @param[in,out] a_K 		The element matrix, with entry (a, b) at
+	 * 							 a*N + b.
+	 * @param[in,out] a_b 		The global right-hand side, with this
+	 * 							 element's contributions added.
+	 * @param[in] a_u 			The current Newton iterate, if any.
+	 ******************************************************************************/
+	void apply(const Condition &a_condition, const int &a_a, const std::vector<int> &a_DoFs, double a_K[], std::vector<double> &a_b, const std::vector<double> &a_u)
+	{
+		int N = a_DoFs.size();
+		int i = a_DoFs[a_a];
+		bool Newton = !a_u.empty();
+
+		switch (a_condition.type)
+		{
+			case Dirichlet:
+			{
+				double value = Newton?a_u[i] - a_condition.value:a_condition.value;
+
+				for (int b=0; b<N; ++b)
+				{
+					if (b == a_a)
+						continue;
+
+					a_b[a_DoFs[b]] -= a_K[b*N + a_a]*value;
+					a_K[b*N + a_a] = 0;
+					a_K[a_a*N + b] = 0;
+				}
+
+				a_K[a_a*N + a_a] = 1;
+				a_b[i] = value;
+				break;
+			}
+
+			case Neumann:
+				a_b[i] += Newton?-a_condition.value:a_condition.value;
+				break;
+
+			case Robin:
+				a_K[a_a*N + a_a] += a_condition.coefficient;
+				a_b[i] += Newton?a_condition.coefficient*a_u[i] - a_condition.value:a_condition.value;
+				break;
+		}
+	}
+}
\ No newline at end of file
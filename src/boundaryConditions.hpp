@@ -0,0 +1,43 @@
+/******************************************************************************
+ * @details This is a file containing declarations of the [boundaryConditions]
+ * 				namespace.
+ * 
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/23
+ ******************************************************************************/
+#ifndef NAMESPACE_BOUNDARYCONDITIONS
+#define NAMESPACE_BOUNDARYCONDITIONS
+
+#include <vector>
+
+namespace boundaryConditions
+{
+	// The ends of the domain.
+	enum Side {Left, Right};
+
+	enum Type {Dirichlet, Neumann, Robin};
+
+	/******************************************************************************
+	 * Condition
+	 * 
+	 * @details    A condition at one end of the domain, with n the outward
+	 * 				normal:
+	 * 				  Dirichlet 	u = value,
+	 * 				  Neumann 		epsilon du/dn = value,
+	 * 				  Robin 		epsilon du/dn + coefficient u = value.
+	 ******************************************************************************/
+	struct Condition
+	{
+		Type   type        = Dirichlet;
+		double value       = 0;
+		double coefficient = 0;
+	};
+
+	Condition dirichlet(const double &a_value);
+	Condition neumann(const double &a_value);
+	Condition robin(const double &a_coefficient, const double &a_value);
+
+	void apply(const Condition &a_condition, const int &a_a, const std::vector<int> &a_DoFs, double a_K[], std::vector<double> &a_b, const std::vector<double> &a_u = std::vector<double>());
+}
+
+#endif
\ No newline at end of file
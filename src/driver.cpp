@@ -98,8 +98,8 @@ int main()
 		Element* currentElement = (*(myNewMesh->elements))[i];
 
 		outputFile
-			<< std::setw(26) << std::setprecision(16) << std::scientific << currentElement->get_nodeCoordinates()[0]
-			<< std::setw(26) << std::setprecision(16) << std::scientific << currentElement->get_nodeCoordinates()[1]
+			<< std::setw(26) << std::setprecision(16) << std::scientific << currentElement->get_leftNode()
+			<< std::setw(26) << std::setprecision(16) << std::scientific << currentElement->get_rightNode()
 			<< std::setw(26) << std::setprecision(16) << std::scientific << currentElement->get_polynomialDegree()
 		<< std::endl;
 	}
@@ -6,10 +6,12 @@
  * @date       2019/12/03
  ******************************************************************************/
 #include "element.hpp"
+#include "basis.hpp"
 #include "common.hpp"
 #include "matrix.hpp"
 #include "matrix_full.hpp"
 #include "quadrature.hpp"
+#include <algorithm>
 #include <cassert>
 #include <functional>
 
@@ -19,78 +21,30 @@
 // ELEMENT CLASS DEFINITION
 // ****************************************************************************
 
-/******************************************************************************
- * __init__
- * 
- * @details 	 	Assigns values passed through from constructor or assignment operator.
- * 
- * @param[in] a_elementNo   		The element number of this element.
- * @param[in] a_noNodes 			Number of nodes in this element.
- * @param[in] a_nodeCoordiantes 	The coordinates of the nodes.
- ******************************************************************************/
-void Element::init_Element(const int &a_elementNo, const int &a_noNodes, const std::vector<int> &a_nodeIndices, const std::vector<double>* a_nodeCoordinates, const int &a_polynomialDegree)
-{
-	this->elementNo = a_elementNo;
-	this->noNodes = a_noNodes;
-	this->nodeIndices = a_nodeIndices;
-	this->nodeCoordinates = a_nodeCoordinates;
-	this->polynomialDegree = a_polynomialDegree;
-}
-
 /******************************************************************************
  * __Element__
  * 
- * @details 	 	Copy constructor.
-
- * @param[in] a_element 	Element to copy.
+ * @details 	 	Default constructor; the view refers to no mesh.
  ******************************************************************************/
-Element::Element(const Element &a_element)
-: Element::Element(	a_element.get_elementNo(),
-					a_element.get_noNodes(),
-					a_element.get_nodeIndices(),
-					a_element.get_rawNodeCoordinates(),
-					a_element.get_polynomialDegree()
-				  )
+Element::Element()
 {
-	//
+	this->elements  = nullptr;
+	this->elementNo = 0;
 }
 
 /******************************************************************************
  * __Element__
  * 
- * @details 	 	The main constructor for an element.
- * 
- * @param a_elementNo   		The element number of this element.
- * @param a_noNodes 			Number of nodes in this element.
- * @param a_nodeCoordiantes 	The coordinates of the nodes.
- ******************************************************************************/
-Element::Element(const int &a_elementNo, const int &a_noNodes, const std::vector<int> &a_nodeIndices, const std::vector<double>* a_nodeCoordiantes, const int &a_polynomialDegree)
-{
-	init_Element(a_elementNo, a_noNodes, a_nodeIndices, a_nodeCoordiantes, a_polynomialDegree);
-}
-
-/******************************************************************************
- * __~Element__
- * 
- * @details 	Destructor.
- ******************************************************************************/
-Element::~Element()
-{
-	//
-}
-
-/******************************************************************************
- * __operator=__
- * 
- * @details 	Equals operator.
+ * @details 	 	The main constructor for an element, viewing the data of
+ * 					one element of a mesh.
  * 
- * @param[in] a_element 	An element passed to the operator.
+ * @param a_elements   		The mesh the element belongs to.
+ * @param a_elementNo   	The element number of this element.
  ******************************************************************************/
-Element& Element::operator=(const Element &a_element)
+Element::Element(Elements* const &a_elements, const int &a_elementNo)
 {
-	init_Element(a_element.get_elementNo(), a_element.get_noNodes(), a_element.get_nodeIndices(), a_element.get_rawNodeCoordinates(), a_element.get_polynomialDegree());
-
-	return *this;
+	this->elements  = a_elements;
+	this->elementNo = a_elementNo;
 }
 
 /******************************************************************************
@@ -101,9 +55,9 @@ Element& Element::operator=(const Element &a_element)
  * @param[in] a_xi 		A local coordinate.
  * @return 				Returns the global coordinate.
  ******************************************************************************/
-double Element::mapLocalToGlobal(const double &a_xi)
+double Element::mapLocalToGlobal(const double &a_xi) const
 {
-	return get_nodeCoordinates()[0] + (a_xi + 1)*get_Jacobian();
+	return this->elements->leftNodes[this->elementNo] + (a_xi + 1)*this->elements->Jacobians[this->elementNo];
 }
 
 /******************************************************************************
@@ -115,7 +69,7 @@ double Element::mapLocalToGlobal(const double &a_xi)
  ******************************************************************************/
 double Element::get_Jacobian() const
 {
-	return (get_nodeCoordinates()[1] - get_nodeCoordinates()[0])/2;
+	return this->elements->Jacobians[this->elementNo];
 }
 
 /******************************************************************************
@@ -129,99 +83,27 @@ double Element::get_Jacobian() const
  ******************************************************************************/
 f_double Element::basisFunction(const int &a_n, const int &a_i)
 {
-	if (a_i==0)
-	{
-		switch(a_n)
-		{
-			case 0: return [](double x) -> double
-					{
-						if (-1 <= x && x <= 1)
-							return (1-x)/2;
-						else
-							return 0;
-					};
-					break;
-			case 1: return [](double x) -> double
-					{
-						if (-1 <= x && x <= 1)
-							return (1+x)/2;
-						else
-							return 0;
-					};
-					break;
-			default: return common::constantMultiplyFunction(
-								sqrt(double(a_n-1)-0.5),
-								common::addFunction(
-									quadrature::legendrePolynomial(a_n, a_i),
-									common::constantMultiplyFunction(
-										-1,
-										quadrature::legendrePolynomial(a_n-2, a_i)
-									)
-								)
-							);
+	return basis::basisFunction(a_n, a_i);
+}
 
-		}
-	}
-	else if (a_i==1)
-	{
-		switch(a_n)
-		{
-			case 0: return [](double x) -> double
-					{
-						if (-1 <= x && x <= 1)
-							return -double(1)/2;
-						else
-							return 0;
-					};
-					break;
-			case 1: return [](double x) -> double
-					{
-						if (-1 <= x && x <= 1)
-							return double(1)/2;
-						else
-							return 0;
-					};
-					break;
-			default: return common::constantMultiplyFunction(
-								sqrt(double(a_n-1)-0.5),
-								common::addFunction(
-									quadrature::legendrePolynomial(a_n, a_i),
-									common::constantMultiplyFunction(
-										-1,
-										quadrature::legendrePolynomial(a_n-2, a_i)
-									)
-								)
-							);
+/******************************************************************************
+ * __basisFunctions__
+ * 
+ * @details 	Evaluates the derivatives 0..i of all shape functions of the
+ * 				element at every given point in one call.
+ * 
+ * @param[in] a_i 		The highest derivative to evaluate.
+ * @param[in] a_xi 		The points on the reference element.
+ * @param[out] a_values The jth derivative of the ath shape function at the
+ * 						 kth point is a_values[(j*(p+1) + a)*a_xi.size() + k].
+ ******************************************************************************/
+void Element::basisFunctions(const int &a_i, const std::vector<double> &a_xi, std::vector<double> &a_values) const
+{
+	int p = this->get_polynomialDegree();
 
-		}
-	}
-	else
-	{
-		switch(a_n)
-		{
-			case 0: return [](double x) -> double
-					{
-						return 0;
-					};
-					break;
-			case 1: return [](double x) -> double
-					{
-						return 0;
-					};
-					break;
-			default: return common::constantMultiplyFunction(
-								sqrt(double(a_n-1)-0.5),
-								common::addFunction(
-									quadrature::legendrePolynomial(a_n, a_i),
-									common::constantMultiplyFunction(
-										-1,
-										quadrature::legendrePolynomial(a_n-2, a_i)
-									)
-								)
-							);
+	a_values.resize((a_i+1)*(p+1)*a_xi.size());
 
-		}
-	}
+	basis::basisFunctions(p, a_i, a_xi.size(), a_xi.data(), a_values.data());
 }
 
 /******************************************************************************
@@ -239,94 +121,216 @@ int Element::get_elementNo() const
 /******************************************************************************
  * __noNodes__
  * 
- * @details 	Returns the value of the private variable 'noNodes'.
+ * @details 	Returns the number of nodes of the element.
  * 
- * @return  	The value of noNodes.
+ * @return  	The number of nodes.
  ******************************************************************************/
 int Element::get_noNodes() const
 {
-	return this->noNodes;
+	return 2;
 }
 
 /******************************************************************************
- * __nodeCoordinates__
+ * __get_leftNode__
  * 
- * @details 	Returns the value of the private variable 'nodeCoordinates'.
+ * @details 	Returns the coordinate of the left node of the element.
  * 
- * @return  	The value of nodeCoordinates.
+ * @return  	The coordinate of the left node.
  ******************************************************************************/
-std::vector<double> Element::get_nodeCoordinates() const
+double Element::get_leftNode() const
 {
-	std::vector<double> tempVector(2);
+	return this->elements->leftNodes[this->elementNo];
+}
 
-	for (int i=0; i<nodeIndices.size(); ++i)
-		tempVector[i] = nodeCoordinates->at(nodeIndices[i]);
+/******************************************************************************
+ * __get_rightNode__
+ * 
+ * @details 	Returns the coordinate of the right node of the element.
+ * 
+ * @return  	The coordinate of the right node.
+ ******************************************************************************/
+double Element::get_rightNode() const
+{
+	return this->elements->rightNodes[this->elementNo];
+}
 
-	return tempVector;
+/******************************************************************************
+ * __nodeCoordinates__
+ * 
+ * @details 	Returns the coordinates of the nodes of the element. Allocates;
+ * 				prefer get_leftNode and get_rightNode in loops.
+ * 
+ * @return  	The coordinates of the nodes.
+ ******************************************************************************/
+std::vector<double> Element::get_nodeCoordinates() const
+{
+	return {this->get_leftNode(), this->get_rightNode()};
 }
 
 const std::vector<double>* Element::get_rawNodeCoordinates() const
 {
-	return this->nodeCoordinates;
+	return &this->elements->nodeCoordinates;
 }
 
 std::vector<int> Element::get_nodeIndices() const
 {
-	return this->nodeIndices;
+	return this->elements->get_elementConnectivity(this->elementNo);
+}
+
+int Element::get_noQuadraturePoints() const
+{
+	return ceil(double(2 * this->get_polynomialDegree() + 1)/2) + 1;
 }
 
 void Element::get_elementQuadrature(std::vector<double> &a_coordinates, std::vector<double> &a_weights) const
 {
-	int n = ceil(double(2 * this->get_polynomialDegree() + 1)/2) + 1;
+	const quadrature::Rule &rule = this->get_elementQuadrature();
 
-	a_coordinates.resize(n);
-	a_weights    .resize(n);
+	a_coordinates.assign(rule.points,  rule.points  + rule.noPoints);
+	a_weights    .assign(rule.weights, rule.weights + rule.noPoints);
+}
 
-	for (int i=0; i<n; ++i)
-	{
-		a_coordinates[i] = quadrature::get_gaussLegendrePoint (n, i);
-		a_weights    [i] = quadrature::get_gaussLegendreWeight(n, i);
-	}
+/******************************************************************************
+ * __get_elementQuadrature__
+ * 
+ * @details 	Returns the quadrature rule used on this element, without
+ * 				copying it.
+ * 
+ * @return  	The quadrature rule.
+ ******************************************************************************/
+const quadrature::Rule& Element::get_elementQuadrature() const
+{
+	return quadrature::get_gaussLegendreRule(this->get_noQuadraturePoints());
+}
+
+/******************************************************************************
+ * __get_elementBasis__
+ * 
+ * @details 	Returns the shape functions of this element tabulated at the
+ * 				points given by get_elementQuadrature.
+ * 
+ * @return  	The tabulated shape functions.
+ ******************************************************************************/
+const basis::Tabulation& Element::get_elementBasis() const
+{
+	return basis::get_tabulation(this->get_polynomialDegree(), this->get_noQuadraturePoints());
+}
+
+/******************************************************************************
+ * __get_noQuadraturePoints__
+ * 
+ * @details 	Returns the number of quadrature points used for an integrand.
+ * 				Gauss-Legendre rules use the same number as
+ * 				get_noQuadraturePoints(); Gauss-Lobatto rules use p+1 points,
+ * 				which gives a diagonal mass matrix for linear elements.
+ * 
+ * @param[in] a_integrand 	The integrand.
+ * @return  				The number of quadrature points.
+ ******************************************************************************/
+int Element::get_noQuadraturePoints(const quadrature::Integrand &a_integrand) const
+{
+	if (this->get_quadraturePolicy(a_integrand) == quadrature::GaussLobatto)
+		return std::max(this->get_polynomialDegree() + 1, 2);
+	else
+		return this->get_noQuadraturePoints();
+}
+
+/******************************************************************************
+ * __get_elementQuadrature__
+ * 
+ * @details 	Returns the quadrature rule used for an integrand on this
+ * 				element, as chosen by its quadrature policy.
+ * 
+ * @param[in] a_integrand 	The integrand.
+ * @return  				The quadrature rule.
+ ******************************************************************************/
+const quadrature::Rule& Element::get_elementQuadrature(const quadrature::Integrand &a_integrand) const
+{
+	return quadrature::get_rule(this->get_quadraturePolicy(a_integrand), this->get_noQuadraturePoints(a_integrand));
+}
+
+/******************************************************************************
+ * __get_elementBasis__
+ * 
+ * @details 	Returns the shape functions of this element tabulated at the
+ * 				points of the quadrature rule used for an integrand.
+ * 
+ * @param[in] a_integrand 	The integrand.
+ * @return  				The tabulated shape functions.
+ ******************************************************************************/
+const basis::Tabulation& Element::get_elementBasis(const quadrature::Integrand &a_integrand) const
+{
+	return basis::get_tabulation(this->get_polynomialDegree(), this->get_noQuadraturePoints(a_integrand), this->get_quadraturePolicy(a_integrand));
+}
+
+quadrature::Family Element::get_quadraturePolicy(const quadrature::Integrand &a_integrand) const
+{
+	return this->elements->quadraturePolicies[this->elementNo*quadrature::noIntegrands + a_integrand];
+}
+
+void Element::set_quadraturePolicy(const quadrature::Integrand &a_integrand, const quadrature::Family &a_family)
+{
+	this->elements->quadraturePolicies[this->elementNo*quadrature::noIntegrands + a_integrand] = a_family;
 }
 
 int Element::get_polynomialDegree() const
 {
-	return this->polynomialDegree;
+	return this->elements->polynomialDegrees[this->elementNo];
 }
 
 void Element::set_polynomialDegree(const int &a_p)
 {
-	this->polynomialDegree = a_p;
+	this->elements->polynomialDegrees[this->elementNo] = a_p;
 }
 
 // ****************************************************************************
 // ELEMENTS CLASS DEFINITION
 // ****************************************************************************
 
+/******************************************************************************
+ * __init_Elements__
+ * 
+ * @details 	Fills the per-element arrays from the node coordinates and
+ * 				polynomial degrees, and creates the element views.
+ * 
+ * @param[in] a_polynomialDegrees 	The polynomial degree of each element.
+ ******************************************************************************/
+void Elements::init_Elements(const std::vector<int> &a_polynomialDegrees)
+{
+	int n = this->noElements;
+
+	this->leftNodes         .resize(n);
+	this->rightNodes        .resize(n);
+	this->Jacobians         .resize(n);
+	this->polynomialDegrees = a_polynomialDegrees;
+	this->startDoFs         .resize(n+1);
+	this->quadraturePolicies.assign(n*quadrature::noIntegrands, quadrature::GaussLegendre);
+	this->elements          .resize(n);
+
+	for (int i=0; i<n; ++i)
+	{
+		this->leftNodes[i]  = this->nodeCoordinates[i];
+		this->rightNodes[i] = this->nodeCoordinates[i+1];
+		this->Jacobians[i]  = (this->rightNodes[i] - this->leftNodes[i])/2;
+		this->elements[i]   = Element(this, i);
+	}
+
+	this->calculateDoFs();
+}
+
 /******************************************************************************
  * __Elements__
  * 
  * @details 	Constructor taking 1 parameter to set number of elements.
+ * 				A negative number puts two thirds of the elements in
+ * 				[0, 1/2].
  * 
  * @param[in] noElements 	Number of elements.
  ******************************************************************************/
 Elements::Elements(const int &a_noElements)
 {
 	// Sets member variable values.
-	this->noElements          = abs(a_noElements);
-	this->elementConnectivity .resize(abs(a_noElements));
-	this->elements   	      = new Element*[abs(a_noElements)];
-	this->startDoFs           .resize(abs(a_noElements)+1);
-
-	// *********************
-	// Element connectivity.
-	// *********************
-	for (int i=0; i<abs(a_noElements); ++i)
-	{
-		this->elementConnectivity[i].resize(2);
-		this->elementConnectivity[i][0] = i;
-		this->elementConnectivity[i][1] = i+1;
-	}
+	this->noElements = abs(a_noElements);
 
 	// *********
 	// Elements.
@@ -340,16 +344,6 @@ Elements::Elements(const int &a_noElements)
 		{
 			this->nodeCoordinates[i] = i*h;
 		}
-
-		// Loops over the creation of each element.
-		std::vector<int> nodeIndices(2);
-		for (int i=0; i<a_noElements; ++i)
-		{
-			nodeIndices[0] = i;
-			nodeIndices[1] = i+1;
-
-			this->elements[i] = new Element(i, 2, nodeIndices, &nodeCoordinates, 1);
-		}
 	}	
 	else
 	{
@@ -365,106 +359,32 @@ Elements::Elements(const int &a_noElements)
 
 		for (int i=0; i<=n2; ++i)
 			nodeCoordinates[n1+i] = h1*n1 + i*h2;
-
-		// Loops over the creation of each element.
-		std::vector<int> nodeIndices(2);
-		for (int i=0; i<n1; ++i)
-		{
-			nodeIndices[0] = i;
-			nodeIndices[1] = i+1;
-
-			this->elements[i] = new Element(i, 2, nodeIndices, &nodeCoordinates, 1);
-		}
-		for (int i=0; i<n2; ++i)
-		{
-			nodeIndices[0] = n1 + i;
-			nodeIndices[1] = n1 + i + 1;
-
-			this->elements[n1 + i] = new Element(i, 2, nodeIndices, &nodeCoordinates, 1);
-		}
 	}
 
-	// *********************
-	// Degrees of freedom.
-	// *********************
-	this->startDoFs[0] = abs(a_noElements) + 1;
-	for (int i=0; i<abs(a_noElements); ++i)
-	{
-		Element* currentElement = this->elements[i];
-		this->startDoFs[i+1] = this->startDoFs[i] + currentElement->get_polynomialDegree() - 1;
-	}
+	init_Elements(std::vector<int>(this->noElements, 1));
 }
 
 Elements::Elements(const int &a_noElements, const std::vector<double> &a_nodeCoordinates)
+: Elements::Elements(a_noElements, a_nodeCoordinates, std::vector<int>(abs(a_noElements), 1))
 {
-	// Sets member variable values.
-	this->noElements          = abs(a_noElements);
-	this->elementConnectivity .resize(abs(a_noElements));
-	this->elements   	      = new Element*[abs(a_noElements)];
-	this->startDoFs           .resize(abs(a_noElements)+1);
-
-	// *********************
-	// Element connectivity.
-	// *********************
-	for (int i=0; i<abs(a_noElements); ++i)
-	{
-		this->elementConnectivity[i].resize(2);
-		this->elementConnectivity[i][0] = i;
-		this->elementConnectivity[i][1] = i+1;
-	}
-
-	// *********
-	// Elements.
-	// *********
-	// Creates the node coordinates.
-	this->nodeCoordinates = a_nodeCoordinates;
-
-	// Loops over the creation of each element.
-	std::vector<int> nodeIndices(2);
-	for (int i=0; i<a_noElements; ++i)
-	{
-		nodeIndices[0] = i;
-		nodeIndices[1] = i+1;
-
-		this->elements[i] = new Element(i, 2, nodeIndices, &nodeCoordinates, 1);
-	}
-
-	// *********************
-	// Degrees of freedom.
-	// *********************
-	this->startDoFs[0] = abs(a_noElements) + 1;
-	for (int i=0; i<abs(a_noElements); ++i)
-	{
-		Element* currentElement = this->elements[i];
-		this->startDoFs[i+1] = this->startDoFs[i] + currentElement->get_polynomialDegree() - 1;
-	}
+	//
 }
 
-Elements::Elements(const int &a_noElements, const std::vector<double> &a_nodeCoordinates, Element*** &a_elements)
+/******************************************************************************
+ * __Elements__
+ * 
+ * @details 	Constructor for a mesh with given nodes and polynomial degrees.
+ * 
+ * @param[in] a_noElements 			Number of elements.
+ * @param[in] a_nodeCoordinates 	The noElements+1 node coordinates, in order.
+ * @param[in] a_polynomialDegrees 	The polynomial degree of each element.
+ ******************************************************************************/
+Elements::Elements(const int &a_noElements, const std::vector<double> &a_nodeCoordinates, const std::vector<int> &a_polynomialDegrees)
 {
-	// Pointer to elements for populating later.
-	a_elements = &this->elements;
-
-	// Sets member variable values.
-	this->noElements          = abs(a_noElements);
-	this->elementConnectivity .resize(abs(a_noElements));
-	this->startDoFs           .resize(abs(a_noElements)+1);
-
-	// *********************
-	// Element connectivity.
-	// *********************
-	for (int i=0; i<abs(a_noElements); ++i)
-	{
-		this->elementConnectivity[i].resize(2);
-		this->elementConnectivity[i][0] = i;
-		this->elementConnectivity[i][1] = i+1;
-	}
-
-	// *********
-	// Elements.
-	// *********
-	// Creates the node coordinates.
+	this->noElements      = abs(a_noElements);
 	this->nodeCoordinates = a_nodeCoordinates;
+
+	init_Elements(a_polynomialDegrees);
 }
 
 /******************************************************************************
@@ -474,7 +394,7 @@ Elements::Elements(const int &a_noElements, const std::vector<double> &a_nodeCoo
  ******************************************************************************/
 Elements::~Elements()
 {
-	delete[] this->elements;
+	//
 }
 
 /******************************************************************************
@@ -487,7 +407,7 @@ Elements::~Elements()
  ******************************************************************************/
 Element* Elements::operator[](const int &a_i)
 {
-	return this->elements[a_i];
+	return &this->elements[a_i];
 }
 
 /******************************************************************************
@@ -504,9 +424,18 @@ int Elements::get_noElements() const
 
 std::vector<int> Elements::get_elementConnectivity(const int &a_i) const
 {
-	return this->elementConnectivity[a_i];
+	return {a_i, a_i+1};
 }
 
+/******************************************************************************
+ * __get_elementDoFs__
+ * 
+ * @details 	The DoFs of an element, in the numbering chosen by
+ * 				set_DoFOrdering: its two nodes, then its higher-order DoFs.
+ * 
+ * @param[in] a_i 	The element number.
+ * @return 			The DoFs of the element.
+ ******************************************************************************/
 std::vector<int> Elements::get_elementDoFs(const int &a_i) const
 {
 	// Standard degrees of freedom.
@@ -519,14 +448,111 @@ std::vector<int> Elements::get_elementDoFs(const int &a_i) const
 	for (int i=start; i<end; ++i)
 		DoFs.push_back(i);
 
+	if (!this->DoFNumbers.empty())
+		for (int a=0; a<DoFs.size(); ++a)
+			DoFs[a] = this->DoFNumbers[DoFs[a]];
+
 	return DoFs;
 }
 
+/******************************************************************************
+ * __get_rawElementDoFs__
+ * 
+ * @details 	As get_elementDoFs, but points into a table kept by the mesh
+ * 				instead of allocating, for loops over quadrature points. The
+ * 				table is rebuilt whenever the DoFs are numbered.
+ * 
+ * @param[in] a_i 	The element number.
+ * @return 			The first of the get_noElementDoFs DoFs of the element.
+ ******************************************************************************/
+const int* Elements::get_rawElementDoFs(const int &a_i) const
+{
+	return &this->elementDoFs[this->elementDoFStarts[a_i]];
+}
+
+int Elements::get_noElementDoFs(const int &a_i) const
+{
+	return this->elementDoFStarts[a_i+1] - this->elementDoFStarts[a_i];
+}
+
+/******************************************************************************
+ * __get_assemblyPattern__
+ * 
+ * @details 	Gives the position of every entry of every element matrix in
+ * 				the global matrix, as the triplets of Matrix_sparse's symbolic
+ * 				phase. For each element, for each a, for each b, the entry is
+ * 				(DoFs[b], DoFs[a]); values must be assembled in the same order.
+ * 
+ * @param[out] a_xs 	The column of each entry.
+ * @param[out] a_ys 	The row of each entry.
+ ******************************************************************************/
+void Elements::get_assemblyPattern(std::vector<int> &a_xs, std::vector<int> &a_ys) const
+{
+	a_xs.clear();
+	a_ys.clear();
+
+	for (int elementNo=0; elementNo<this->noElements; ++elementNo)
+	{
+		std::vector<int> DoFs = this->get_elementDoFs(elementNo);
+
+		for (int a=0; a<DoFs.size(); ++a)
+			for (int b=0; b<DoFs.size(); ++b)
+			{
+				a_xs.push_back(DoFs[b]);
+				a_ys.push_back(DoFs[a]);
+			}
+	}
+}
+
+/******************************************************************************
+ * __get_elementBlocks__
+ * 
+ * @details 	Gives one block per element holding all of its DoFs, so that
+ * 				neighbouring blocks overlap at their shared node.
+ * 
+ * @param[out] a_blockStarts 	Where each block starts in a_blockDoFs, with
+ * 								 the number of DoFs appended.
+ * @param[out] a_blockDoFs 		The DoFs of each block.
+ ******************************************************************************/
+void Elements::get_elementBlocks(std::vector<int> &a_blockStarts, std::vector<int> &a_blockDoFs) const
+{
+	a_blockStarts.assign(1, 0);
+	a_blockDoFs.clear();
+
+	for (int elementNo=0; elementNo<this->noElements; ++elementNo)
+	{
+		const int* elementDoFs = this->get_rawElementDoFs(elementNo);
+		a_blockDoFs.insert(a_blockDoFs.end(), elementDoFs, elementDoFs + this->get_noElementDoFs(elementNo));
+
+		a_blockStarts.push_back(a_blockDoFs.size());
+	}
+}
+
 int Elements::get_DoF() const
 {
 	return this->startDoFs.back();
 }
 
+/******************************************************************************
+ * __get_DoFNumber__
+ * 
+ * @details 	The number given to a DoF by the chosen ordering, where DoFs
+ * 				are identified by their NodesFirst number: node i is DoF i,
+ * 				and the higher-order DoFs of each element follow the nodes.
+ * 
+ * @param[in] a_i 	The NodesFirst number of the DoF.
+ * @return 			Its number in the chosen ordering.
+ ******************************************************************************/
+int Elements::get_DoFNumber(const int &a_i) const
+{
+	return this->DoFNumbers.empty()?a_i:this->DoFNumbers[a_i];
+}
+
+Elements::DoFOrdering Elements::get_DoFOrdering() const
+{
+	return this->ordering;
+}
+
 std::vector<double> Elements::get_nodeCoordinates() const
 {
 	return this->nodeCoordinates;
@@ -539,22 +565,136 @@ const std::vector<double>* Elements::get_rawNodeCoordinates() const
 
 std::vector<int> Elements::get_polynomialDegrees() const
 {
-	int n = this->noElements;
-
-	std::vector<int> output(n);
-
-	for (int i=0; i<n; ++i)
-		output[i] = this->elements[i]->get_polynomialDegree();
-
-	return output;
+	return this->polynomialDegrees;
 }
 
 void Elements::calculateDoFs()
 {
 	this->startDoFs[0] = this->noElements + 1;
 	for (int i=0; i<this->noElements; ++i)
+		this->startDoFs[i+1] = this->startDoFs[i] + this->polynomialDegrees[i] - 1;
+
+	this->number_DoFs();
+}
+
+/******************************************************************************
+ * __set_DoFOrdering__
+ * 
+ * @details 	Chooses how the DoFs are numbered, which decides the bandwidth
+ * 				of the global matrices: with NodesFirst it grows with the
+ * 				number of elements, as each element's higher-order DoFs are
+ * 				numbered after every node; Interleaved gives the smallest
+ * 				bandwidth, p, and ReverseCuthillMcKee finds a small one from
+ * 				the connectivity alone. Solutions must be solved again after
+ * 				the numbering changes.
+ * 
+ * @param[in] a_ordering 	The ordering.
+ ******************************************************************************/
+void Elements::set_DoFOrdering(const DoFOrdering &a_ordering)
+{
+	this->ordering = a_ordering;
+	this->number_DoFs();
+}
+
+/******************************************************************************
+ * __number_DoFs__
+ * 
+ * @details 	Fills DoFNumbers with the number of each NodesFirst DoF in the
+ * 				chosen ordering, leaving it empty for NodesFirst itself, and
+ * 				tabulates the DoFs of every element in that ordering.
+ ******************************************************************************/
+void Elements::number_DoFs()
+{
+	int n = this->get_DoF();
+	this->DoFNumbers.clear();
+
+	switch (this->ordering)
+	{
+		case Interleaved:
+		{
+			this->DoFNumbers.resize(n);
+
+			int DoFNo = 0;
+			for (int elementNo=0; elementNo<this->noElements; ++elementNo)
+			{
+				this->DoFNumbers[elementNo] = DoFNo++;
+
+				for (int i=this->startDoFs[elementNo]; i<this->startDoFs[elementNo+1]; ++i)
+					this->DoFNumbers[i] = DoFNo++;
+			}
+			this->DoFNumbers[this->noElements] = DoFNo;
+
+			break;
+		}
+
+		case ReverseCuthillMcKee:
+		{
+			// The graph of the global matrix, in the NodesFirst numbering.
+			std::vector<std::vector<int>> neighbours(n);
+			for (int elementNo=0; elementNo<this->noElements; ++elementNo)
+			{
+				std::vector<int> DoFs = this->get_elementDoFs(elementNo);
+
+				for (int a=0; a<DoFs.size(); ++a)
+					for (int b=0; b<DoFs.size(); ++b)
+						if (a != b)
+							neighbours[DoFs[a]].push_back(DoFs[b]);
+			}
+
+			for (int i=0; i<n; ++i)
+			{
+				std::sort(neighbours[i].begin(), neighbours[i].end());
+				neighbours[i].erase(std::unique(neighbours[i].begin(), neighbours[i].end()), neighbours[i].end());
+			}
+
+			for (int i=0; i<n; ++i)
+				std::stable_sort(neighbours[i].begin(), neighbours[i].end(), [&](const int &a_i, const int &a_j)
+				{
+					return neighbours[a_i].size() < neighbours[a_j].size();
+				});
+
+			// Breadth-first from a DoF of least degree, visiting neighbours in
+			//  order of increasing degree; repeated for each component.
+			std::vector<int> order;
+			std::vector<bool> visited(n, false);
+			order.reserve(n);
+			while (order.size() < n)
+			{
+				int start = -1;
+				for (int i=0; i<n; ++i)
+					if (!visited[i] && (start < 0 || neighbours[i].size() < neighbours[start].size()))
+						start = i;
+
+				visited[start] = true;
+				order.push_back(start);
+
+				for (int k=order.size()-1; k<order.size(); ++k)
+					for (int j : neighbours[order[k]])
+						if (!visited[j])
+						{
+							visited[j] = true;
+							order.push_back(j);
+						}
+			}
+
+			// Reversed.
+			this->DoFNumbers.resize(n);
+			for (int k=0; k<n; ++k)
+				this->DoFNumbers[order[k]] = n-1-k;
+
+			break;
+		}
+
+		default:
+			break;
+	}
+
+	this->elementDoFStarts.assign(1, 0);
+	this->elementDoFs.clear();
+	for (int elementNo=0; elementNo<this->noElements; ++elementNo)
 	{
-		Element* currentElement = this->elements[i];
-		this->startDoFs[i+1] = this->startDoFs[i] + currentElement->get_polynomialDegree() - 1;
+		std::vector<int> DoFs = this->get_elementDoFs(elementNo);
+		this->elementDoFs.insert(this->elementDoFs.end(), DoFs.begin(), DoFs.end());
+		this->elementDoFStarts.push_back(this->elementDoFs.size());
 	}
 }
\ No newline at end of file
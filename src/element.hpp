@@ -8,66 +8,107 @@
 #ifndef CLASS_ELEMENT
 #define CLASS_ELEMENT
 
+#include "basis.hpp"
 #include "common.hpp"
 #include "matrix.hpp"
 #include "matrix_full.hpp"
+#include "quadrature.hpp"
 #include <functional>
 #include <vector>
 
+class Elements;
+
+// Lightweight view of one element of an [Elements] mesh; all of its data is
+//  stored in the mesh.
 class Element
 {
-	// Mark as boundary?
 	private:
+		Elements* elements;
 		int elementNo;
-		int noNodes;
-		int polynomialDegree;
-		std::vector<int> nodeIndices;
-		const std::vector<double>* nodeCoordinates;
-		// Node coordiantes stored in elements, which a connectiviy array in element to tell you which nodes you're talking about.
-		void init_Element(const int &a_elementNo, const int &a_noNodes, const std::vector<int> &a_nodeIndices, const std::vector<double>* a_nodeCoordinates, const int &a_polynomialDegree);
 
 	public:
-		Element(const Element &a_element);
-		Element(const int &a_elementNo, const int &a_noNodes, const std::vector<int> &a_nodeIndices, const std::vector<double>* a_nodeCoordinates, const int &a_polynomialDegree);
-		~Element();
-		Element& operator= (const Element &a_element);
-		double mapLocalToGlobal(const double &a_xi);
+		Element();
+		Element(Elements* const &a_elements, const int &a_elementNo);
+		double mapLocalToGlobal(const double &a_xi) const;
 		double get_Jacobian() const;
 		f_double basisFunction(const int &a_n, const int &a_i);
+		void basisFunctions(const int &a_i, const std::vector<double> &a_xi, std::vector<double> &a_values) const;
 
 		int get_elementNo() const;
 		int get_noNodes() const;
+		double get_leftNode() const;
+		double get_rightNode() const;
 		std::vector<double> get_nodeCoordinates() const;
 		const std::vector<double>* get_rawNodeCoordinates() const;
 		std::vector<int> get_nodeIndices() const;
+		int get_noQuadraturePoints() const;
 		void get_elementQuadrature(std::vector<double> &a_coordinates, std::vector<double> &a_weights) const;
+		const quadrature::Rule& get_elementQuadrature() const;
+		const basis::Tabulation& get_elementBasis() const;
+		int get_noQuadraturePoints(const quadrature::Integrand &a_integrand) const;
+		const quadrature::Rule& get_elementQuadrature(const quadrature::Integrand &a_integrand) const;
+		const basis::Tabulation& get_elementBasis(const quadrature::Integrand &a_integrand) const;
+		quadrature::Family get_quadraturePolicy(const quadrature::Integrand &a_integrand) const;
+		void set_quadraturePolicy(const quadrature::Integrand &a_integrand, const quadrature::Family &a_family);
 		int get_polynomialDegree() const;
 		void set_polynomialDegree(const int &a_p);
 };
 
+// Mesh of 1D elements, stored as contiguous arrays indexed by element.
 class Elements
 {
+	friend class Element;
+
+	public:
+		// Ways of numbering the DoFs. NodesFirst numbers the nodes, then the
+		//  higher-order DoFs element by element; Interleaved puts each
+		//  element's higher-order DoFs between its nodes.
+		enum DoFOrdering {NodesFirst, Interleaved, ReverseCuthillMcKee};
+
 	private:
 		int noElements;
-		std::vector<std::vector<int>> elementConnectivity;
-		Element** elements;
 		std::vector<double> nodeCoordinates;
-		std::vector<double> startDoFs;
+		std::vector<double> leftNodes;
+		std::vector<double> rightNodes;
+		std::vector<double> Jacobians;
+		std::vector<int> polynomialDegrees;
+		std::vector<int> startDoFs;
+		DoFOrdering ordering = NodesFirst;
+		std::vector<int> DoFNumbers;
+		std::vector<int> elementDoFStarts;
+		std::vector<int> elementDoFs;
+		std::vector<quadrature::Family> quadraturePolicies;
+		std::vector<Element> elements;
+
+		void init_Elements(const std::vector<int> &a_polynomialDegrees);
+		void number_DoFs();
 
 	public:
 		Elements(const int &a_noElements);
 		Elements(const int &a_noElements, const std::vector<double> &a_nodeCoordinates);
-		Elements(const int &a_noElements, const std::vector<double> &a_nodeCoordinates, Element*** &a_elements);
+		Elements(const int &a_noElements, const std::vector<double> &a_nodeCoordinates, const std::vector<int> &a_polynomialDegrees);
 		~Elements();
+
+		// The element views point back at the mesh, so it is not copied.
+		Elements(const Elements &a_elements) = delete;
+		Elements& operator=(const Elements &a_elements) = delete;
+
 		Element* operator[](const int &a_i);
 		int get_noElements() const;
 		std::vector<int> get_elementConnectivity(const int &a_i) const;
 		std::vector<int> get_elementDoFs(const int &a_i) const;
+		const int* get_rawElementDoFs(const int &a_i) const;
+		int get_noElementDoFs(const int &a_i) const;
+		void get_assemblyPattern(std::vector<int> &a_xs, std::vector<int> &a_ys) const;
+		void get_elementBlocks(std::vector<int> &a_blockStarts, std::vector<int> &a_blockDoFs) const;
 		std::vector<double> get_nodeCoordinates() const;
 		const std::vector<double>* get_rawNodeCoordinates() const;
 		int get_DoF() const;
+		int get_DoFNumber(const int &a_i) const;
+		DoFOrdering get_DoFOrdering() const;
 		std::vector<int> get_polynomialDegrees() const;
 		void calculateDoFs();
+		void set_DoFOrdering(const DoFOrdering &a_ordering);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,755 @@
+/******************************************************************************
+ * @details This is a file containing the matrix-vector and shape function
+ * 				kernels of the [kernels] namespace, with vectorised versions
+ * 				picked at run time from what the processor supports.
+ *
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/14
+ ******************************************************************************/
+#include "kernels.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+	#define KERNELS_X86
+	#include <immintrin.h>
+#endif
+
+namespace kernels
+{
+	namespace
+	{
+		/******************************************************************************
+		 * csrMultiply_scalar
+		 *
+		 * @details    The plain loop, used when nothing better is available.
+		 ******************************************************************************/
+		void csrMultiply_scalar(const int &a_noRows, const int a_rowStarts[], const int a_columnNos[], const double a_entries[], const double a_x[], double a_y[])
+		{
+			for (int j=0; j<a_noRows; ++j)
+			{
+				double sum = 0;
+
+				for (int index=a_rowStarts[j]; index<a_rowStarts[j+1]; ++index)
+					sum += a_entries[index] * a_x[a_columnNos[index]];
+
+				a_y[j] = sum;
+			}
+		}
+
+		/******************************************************************************
+		 * bandedMultiply_scalar
+		 *
+		 * @details    Each stored entry of row j is used twice: for row j
+		 * 				against x, and for its mirror in column j. Rows near the
+		 * 				end are shorter, as the band runs off the matrix. Starts
+		 * 				from a_firstRow, to finish what another kernel began.
+		 ******************************************************************************/
+		void bandedMultiply_scalar(const int &a_noRows, const int &a_bandwidth, const double a_bands[], const double a_x[], double a_y[], const int &a_firstRow = 0)
+		{
+			for (int j=a_firstRow; j<a_noRows; ++j)
+			{
+				const double* row = a_bands + j*(a_bandwidth+1);
+				int width = std::min(a_bandwidth, a_noRows-1-j);
+
+				double sum = row[0]*a_x[j];
+				for (int k=1; k<=width; ++k)
+				{
+					sum      += row[k]*a_x[j+k];
+					a_y[j+k] += row[k]*a_x[j];
+				}
+
+				a_y[j] += sum;
+			}
+		}
+
+
+		/******************************************************************************
+		 * legendreBasis_scalar
+		 *
+		 * @details    The plain loops. The Legendre recurrences are run across
+		 * 				all points at once, so each loop is over contiguous
+		 * 				points.
+		 ******************************************************************************/
+		void legendreBasis_scalar(const int &a_p, const int &a_i, const int &a_m, const double a_x[], double a_P[], double a_values[])
+		{
+			const int N = a_p + 1;
+			const int m = a_m;
+
+			std::fill(a_P, a_P + m, 1.0);
+			if (a_p >= 1)
+				std::copy(a_x, a_x + m, a_P + m);
+			for (int n=2; n<=a_p; ++n)
+			{
+				double*       P_n  = &a_P[n*m];
+				const double* P_n1 = &a_P[(n-1)*m];
+				const double* P_n2 = &a_P[(n-2)*m];
+
+				for (int k=0; k<m; ++k)
+					P_n[k] = (double(2*n-1)*a_x[k]*P_n1[k] - double(n-1)*P_n2[k])/n;
+			}
+
+			for (int j=1; j<=a_i; ++j)
+			{
+				double*       P_j  = &a_P[j*N*m];
+				const double* P_j_ = &a_P[(j-1)*N*m];
+
+				std::fill(P_j, P_j + m, 0.0);
+				if (a_p >= 1)
+					std::fill(P_j + m, P_j + 2*m, (j==1)?1.0:0.0);
+				for (int n=2; n<=a_p; ++n)
+					for (int k=0; k<m; ++k)
+						P_j[n*m + k] = P_j[(n-2)*m + k] + (2*n-1)*P_j_[(n-1)*m + k];
+			}
+
+			for (int j=0; j<=a_i; ++j)
+			{
+				double*       row = &a_values[j*N*m];
+				const double* P_j = &a_P[j*N*m];
+
+				for (int k=0; k<m; ++k)
+				{
+					bool inside = (-1 <= a_x[k] && a_x[k] <= 1);
+
+					row[k] = (!inside || j>=2)?0:(j==0)?(1-a_x[k])/2:-double(1)/2;
+					if (a_p >= 1)
+						row[m + k] = (!inside || j>=2)?0:(j==0)?(1+a_x[k])/2:double(1)/2;
+				}
+
+				for (int a=2; a<=a_p; ++a)
+				{
+					double c = sqrt(double(a-1)-0.5);
+
+					for (int k=0; k<m; ++k)
+						row[a*m + k] = c * (P_j[a*m + k] - P_j[(a-2)*m + k]);
+				}
+			}
+		}
+
+#ifdef KERNELS_X86
+		__attribute__((target("avx2,fma")))
+		double horizontalSum_avx2(const __m256d &a_sum)
+		{
+			__m128d sum = _mm_add_pd(_mm256_castpd256_pd128(a_sum), _mm256_extractf128_pd(a_sum, 1));
+			sum = _mm_add_sd(sum, _mm_unpackhi_pd(sum, sum));
+
+			return _mm_cvtsd_f64(sum);
+		}
+
+		/******************************************************************************
+		 * csrMultiply_avx2
+		 *
+		 * @details    Four entries of a row at a time, gathering the matching
+		 * 				entries of x.
+		 ******************************************************************************/
+		__attribute__((target("avx2,fma")))
+		void csrMultiply_avx2(const int &a_noRows, const int a_rowStarts[], const int a_columnNos[], const double a_entries[], const double a_x[], double a_y[])
+		{
+			// The masked gather, as the plain one trips -Wmaybe-uninitialized.
+			const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+
+			for (int j=0; j<a_noRows; ++j)
+			{
+				int index = a_rowStarts[j];
+				int end   = a_rowStarts[j+1];
+
+				double total = 0;
+				if (end - index >= 4)
+				{
+					__m256d sum = _mm256_setzero_pd();
+					for (; index+4<=end; index+=4)
+					{
+						__m128i columns = _mm_loadu_si128((const __m128i*)(a_columnNos + index));
+						__m256d x       = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), a_x, columns, all, 8);
+						sum = _mm256_fmadd_pd(_mm256_loadu_pd(a_entries + index), x, sum);
+					}
+
+					total = horizontalSum_avx2(sum);
+				}
+
+				for (; index<end; ++index)
+					total += a_entries[index] * a_x[a_columnNos[index]];
+
+				a_y[j] = total;
+			}
+		}
+
+		/******************************************************************************
+		 * bandedMultiply_avx2
+		 *
+		 * @details    The row and both of its stretches of x and y are
+		 * 				contiguous, so four entries at a time need no gather.
+		 ******************************************************************************/
+		__attribute__((target("avx2,fma")))
+		void bandedMultiply_avx2(const int &a_noRows, const int &a_bandwidth, const double a_bands[], const double a_x[], double a_y[])
+		{
+			for (int j=0; j<a_noRows; ++j)
+			{
+				const double* row = a_bands + j*(a_bandwidth+1);
+				int width = std::min(a_bandwidth, a_noRows-1-j);
+
+				const double* x = a_x + j;
+				double*       y = a_y + j;
+				__m256d x_j = _mm256_set1_pd(x[0]);
+
+				int k = 1;
+				__m256d sum = _mm256_setzero_pd();
+				for (; k+4<=width+1; k+=4)
+				{
+					__m256d entries = _mm256_loadu_pd(row + k);
+					sum = _mm256_fmadd_pd(entries, _mm256_loadu_pd(x + k), sum);
+					_mm256_storeu_pd(y + k, _mm256_fmadd_pd(entries, x_j, _mm256_loadu_pd(y + k)));
+				}
+
+				double total = row[0]*x[0] + horizontalSum_avx2(sum);
+				for (; k<=width; ++k)
+				{
+					total += row[k]*x[k];
+					y[k]  += row[k]*x[0];
+				}
+
+				y[0] += total;
+			}
+		}
+
+		/******************************************************************************
+		 * narrowBandedMultiply_avx2
+		 *
+		 * @details    For half-bandwidths up to 4. Rather than updating y in
+		 * 				memory for the mirrored entries, which makes each row
+		 * 				wait on the stores of the last, their contributions to
+		 * 				the next four entries of y are kept in a register that
+		 * 				shifts down a row at a time. Two rows are taken per step,
+		 * 				so the shifts depend on each other half as often. The
+		 * 				last rows, where the band runs off the matrix, are left
+		 * 				to the scalar kernel.
+		 ******************************************************************************/
+		__attribute__((target("avx2,fma")))
+		void narrowBandedMultiply_avx2(const int &a_noRows, const int &a_bandwidth, const double a_bands[], const double a_x[], double a_y[])
+		{
+			const __m256i mask = _mm256_cmpgt_epi64(_mm256_set1_epi64x(a_bandwidth), _mm256_setr_epi64x(0, 1, 2, 3));
+			const __m256d zero = _mm256_setzero_pd();
+
+			// Lane k holds what earlier rows add to y[j+k].
+			__m256d pending = zero;
+
+			int j = 0;
+			for (; j+1<a_noRows-a_bandwidth; j+=2)
+			{
+				const double* row0 = a_bands + j*(a_bandwidth+1);
+				const double* row1 = row0 + a_bandwidth+1;
+
+				__m256d entries0 = _mm256_maskload_pd(row0 + 1, mask);
+				__m256d entries1 = _mm256_maskload_pd(row1 + 1, mask);
+				__m256d mirror0  = _mm256_mul_pd(entries0, _mm256_set1_pd(a_x[j]));
+				__m256d mirror1  = _mm256_mul_pd(entries1, _mm256_set1_pd(a_x[j+1]));
+
+				__m128d pendingLow = _mm256_castpd256_pd128(pending);
+				a_y[j]   = horizontalSum_avx2(_mm256_mul_pd(entries0, _mm256_maskload_pd(a_x + j+1, mask)))
+				         + row0[0]*a_x[j] + _mm_cvtsd_f64(pendingLow);
+				a_y[j+1] = horizontalSum_avx2(_mm256_mul_pd(entries1, _mm256_maskload_pd(a_x + j+2, mask)))
+				         + row1[0]*a_x[j+1] + _mm_cvtsd_f64(_mm_unpackhi_pd(pendingLow, pendingLow)) + _mm_cvtsd_f64(_mm256_castpd256_pd128(mirror0));
+
+				// Shifts down by one lane for mirror0 and by two for pending.
+				mirror0 = _mm256_blend_pd(_mm256_permute4x64_pd(mirror0, _MM_SHUFFLE(0, 3, 2, 1)), zero, 0x8);
+				pending = _mm256_add_pd(_mm256_permute2f128_pd(pending, pending, 0x81), _mm256_add_pd(mirror0, mirror1));
+			}
+
+			// y is still zero from row j on.
+			double rest[4];
+			_mm256_storeu_pd(rest, pending);
+			for (int k=0; k<4 && j+k<a_noRows; ++k)
+				a_y[j+k] = rest[k];
+
+			bandedMultiply_scalar(a_noRows, a_bandwidth, a_bands, a_x, a_y, j);
+		}
+
+		/******************************************************************************
+		 * legendreBasis_avx2
+		 *
+		 * @details    As legendreBasis_scalar, four points at a time. The
+		 * 				recurrences fuse their multiplies and adds, so values may
+		 * 				differ from the scalar ones in the last bit.
+		 ******************************************************************************/
+		__attribute__((target("avx2,fma")))
+		void legendreBasis_avx2(const int &a_p, const int &a_i, const int &a_m, const double a_x[], double a_P[], double a_values[])
+		{
+			const int N = a_p + 1;
+			const int m = a_m;
+			const int end = m - m%4;
+
+			std::fill(a_P, a_P + m, 1.0);
+			if (a_p >= 1)
+				std::copy(a_x, a_x + m, a_P + m);
+			for (int n=2; n<=a_p; ++n)
+			{
+				double*       P_n  = &a_P[n*m];
+				const double* P_n1 = &a_P[(n-1)*m];
+				const double* P_n2 = &a_P[(n-2)*m];
+
+				__m256d a = _mm256_set1_pd(2*n-1);
+				__m256d b = _mm256_set1_pd(n-1);
+				__m256d c = _mm256_set1_pd(n);
+				int k = 0;
+				for (; k<end; k+=4)
+				{
+					__m256d term = _mm256_fmsub_pd(_mm256_mul_pd(a, _mm256_loadu_pd(a_x + k)), _mm256_loadu_pd(P_n1 + k), _mm256_mul_pd(b, _mm256_loadu_pd(P_n2 + k)));
+					_mm256_storeu_pd(P_n + k, _mm256_div_pd(term, c));
+				}
+				for (; k<m; ++k)
+					P_n[k] = (double(2*n-1)*a_x[k]*P_n1[k] - double(n-1)*P_n2[k])/n;
+			}
+
+			for (int j=1; j<=a_i; ++j)
+			{
+				double*       P_j  = &a_P[j*N*m];
+				const double* P_j_ = &a_P[(j-1)*N*m];
+
+				std::fill(P_j, P_j + m, 0.0);
+				if (a_p >= 1)
+					std::fill(P_j + m, P_j + 2*m, (j==1)?1.0:0.0);
+				for (int n=2; n<=a_p; ++n)
+				{
+					__m256d a = _mm256_set1_pd(2*n-1);
+					int k = 0;
+					for (; k<end; k+=4)
+						_mm256_storeu_pd(P_j + n*m + k, _mm256_fmadd_pd(a, _mm256_loadu_pd(P_j_ + (n-1)*m + k), _mm256_loadu_pd(P_j + (n-2)*m + k)));
+					for (; k<m; ++k)
+						P_j[n*m + k] = P_j[(n-2)*m + k] + (2*n-1)*P_j_[(n-1)*m + k];
+				}
+			}
+
+			const __m256d one  = _mm256_set1_pd(1);
+			const __m256d two  = _mm256_set1_pd(2);
+			const __m256d half = _mm256_set1_pd(0.5);
+			for (int j=0; j<=a_i; ++j)
+			{
+				double*       row = &a_values[j*N*m];
+				const double* P_j = &a_P[j*N*m];
+
+				int k = 0;
+				for (; k<end; k+=4)
+				{
+					__m256d x = _mm256_loadu_pd(a_x + k);
+					__m256d inside = _mm256_and_pd(_mm256_cmp_pd(x, -one, _CMP_GE_OQ), _mm256_cmp_pd(x, one, _CMP_LE_OQ));
+
+					__m256d left  = (j==0)?_mm256_div_pd(_mm256_sub_pd(one, x), two):(j==1)?-half:_mm256_setzero_pd();
+					__m256d right = (j==0)?_mm256_div_pd(_mm256_add_pd(one, x), two):(j==1)? half:_mm256_setzero_pd();
+					_mm256_storeu_pd(row + k, _mm256_and_pd(inside, left));
+					if (a_p >= 1)
+						_mm256_storeu_pd(row + m + k, _mm256_and_pd(inside, right));
+				}
+				for (; k<m; ++k)
+				{
+					bool inside = (-1 <= a_x[k] && a_x[k] <= 1);
+
+					row[k] = (!inside || j>=2)?0:(j==0)?(1-a_x[k])/2:-double(1)/2;
+					if (a_p >= 1)
+						row[m + k] = (!inside || j>=2)?0:(j==0)?(1+a_x[k])/2:double(1)/2;
+				}
+
+				for (int a=2; a<=a_p; ++a)
+				{
+					double c = sqrt(double(a-1)-0.5);
+
+					__m256d c_ = _mm256_set1_pd(c);
+					k = 0;
+					for (; k<end; k+=4)
+						_mm256_storeu_pd(row + a*m + k, _mm256_mul_pd(c_, _mm256_sub_pd(_mm256_loadu_pd(P_j + a*m + k), _mm256_loadu_pd(P_j + (a-2)*m + k))));
+					for (; k<m; ++k)
+						row[a*m + k] = c * (P_j[a*m + k] - P_j[(a-2)*m + k]);
+				}
+			}
+		}
+
+		// The zero-masked forms are used to take vectors apart, as the plain
+		//  ones start from undefined vectors that trip -Wmaybe-uninitialized.
+		__attribute__((target("avx512f")))
+		__m128d lowQuarter_avx512(const __m512d &a_vector)
+		{
+			return _mm256_castpd256_pd128(_mm512_maskz_extractf64x4_pd(0xF, a_vector, 0));
+		}
+
+		__attribute__((target("avx512f")))
+		double horizontalSum_avx512(const __m512d &a_sum)
+		{
+			__m256d sum256 = _mm256_add_pd(_mm512_maskz_extractf64x4_pd(0xF, a_sum, 0), _mm512_maskz_extractf64x4_pd(0xF, a_sum, 1));
+			__m128d sum = _mm_add_pd(_mm256_castpd256_pd128(sum256), _mm256_extractf128_pd(sum256, 1));
+			sum = _mm_add_sd(sum, _mm_unpackhi_pd(sum, sum));
+
+			return _mm_cvtsd_f64(sum);
+		}
+
+		/******************************************************************************
+		 * csrMultiply_avx512
+		 *
+		 * @details    As csrMultiply_avx2, eight entries at a time.
+		 ******************************************************************************/
+		__attribute__((target("avx512f")))
+		void csrMultiply_avx512(const int &a_noRows, const int a_rowStarts[], const int a_columnNos[], const double a_entries[], const double a_x[], double a_y[])
+		{
+			for (int j=0; j<a_noRows; ++j)
+			{
+				int index = a_rowStarts[j];
+				int end   = a_rowStarts[j+1];
+
+				double total = 0;
+				if (end - index >= 8)
+				{
+					__m512d sum = _mm512_setzero_pd();
+					for (; index+8<=end; index+=8)
+					{
+						__m256i columns = _mm256_loadu_si256((const __m256i*)(a_columnNos + index));
+						__m512d x       = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, columns, a_x, 8);
+						sum = _mm512_fmadd_pd(_mm512_loadu_pd(a_entries + index), x, sum);
+					}
+
+					total = horizontalSum_avx512(sum);
+				}
+
+				for (; index<end; ++index)
+					total += a_entries[index] * a_x[a_columnNos[index]];
+
+				a_y[j] = total;
+			}
+		}
+
+		__attribute__((target("avx512f")))
+		void bandedMultiply_avx512(const int &a_noRows, const int &a_bandwidth, const double a_bands[], const double a_x[], double a_y[])
+		{
+			for (int j=0; j<a_noRows; ++j)
+			{
+				const double* row = a_bands + j*(a_bandwidth+1);
+				int width = std::min(a_bandwidth, a_noRows-1-j);
+
+				const double* x = a_x + j;
+				double*       y = a_y + j;
+				__m512d x_j = _mm512_set1_pd(x[0]);
+
+				int k = 1;
+				__m512d sum = _mm512_setzero_pd();
+				for (; k+8<=width+1; k+=8)
+				{
+					__m512d entries = _mm512_loadu_pd(row + k);
+					sum = _mm512_fmadd_pd(entries, _mm512_loadu_pd(x + k), sum);
+					_mm512_storeu_pd(y + k, _mm512_fmadd_pd(entries, x_j, _mm512_loadu_pd(y + k)));
+				}
+
+				double total = row[0]*x[0] + horizontalSum_avx512(sum);
+				for (; k<=width; ++k)
+				{
+					total += row[k]*x[k];
+					y[k]  += row[k]*x[0];
+				}
+
+				y[0] += total;
+			}
+		}
+
+		/******************************************************************************
+		 * narrowBandedMultiply_avx512
+		 *
+		 * @details    As narrowBandedMultiply_avx2, for half-bandwidths up to 8.
+		 ******************************************************************************/
+		__attribute__((target("avx512f")))
+		void narrowBandedMultiply_avx512(const int &a_noRows, const int &a_bandwidth, const double a_bands[], const double a_x[], double a_y[])
+		{
+			const __mmask8 mask = (1u << a_bandwidth) - 1;
+			const __m512i  zero = _mm512_setzero_si512();
+
+			// Lane k holds what earlier rows add to y[j+k].
+			__m512d pending = _mm512_setzero_pd();
+
+			int j = 0;
+			for (; j+1<a_noRows-a_bandwidth; j+=2)
+			{
+				const double* row0 = a_bands + j*(a_bandwidth+1);
+				const double* row1 = row0 + a_bandwidth+1;
+
+				__m512d entries0 = _mm512_maskz_loadu_pd(mask, row0 + 1);
+				__m512d entries1 = _mm512_maskz_loadu_pd(mask, row1 + 1);
+				__m512d mirror0  = _mm512_mul_pd(entries0, _mm512_set1_pd(a_x[j]));
+				__m512d mirror1  = _mm512_mul_pd(entries1, _mm512_set1_pd(a_x[j+1]));
+
+				__m128d pendingLow = lowQuarter_avx512(pending);
+				a_y[j]   = horizontalSum_avx512(_mm512_mul_pd(entries0, _mm512_maskz_loadu_pd(mask, a_x + j+1)))
+				         + row0[0]*a_x[j] + _mm_cvtsd_f64(pendingLow);
+				a_y[j+1] = horizontalSum_avx512(_mm512_mul_pd(entries1, _mm512_maskz_loadu_pd(mask, a_x + j+2)))
+				         + row1[0]*a_x[j+1] + _mm_cvtsd_f64(_mm_unpackhi_pd(pendingLow, pendingLow)) + _mm_cvtsd_f64(lowQuarter_avx512(mirror0));
+
+				// Shifts down by one lane for mirror0 and by two for pending.
+				mirror0 = _mm512_castsi512_pd(_mm512_maskz_alignr_epi64(0xFF, zero, _mm512_castpd_si512(mirror0), 1));
+				pending = _mm512_add_pd(_mm512_castsi512_pd(_mm512_maskz_alignr_epi64(0xFF, zero, _mm512_castpd_si512(pending), 2)), _mm512_add_pd(mirror0, mirror1));
+			}
+
+			// y is still zero from row j on.
+			_mm512_mask_storeu_pd(a_y + j, (1u << std::min(8, a_noRows-j)) - 1, pending);
+
+			bandedMultiply_scalar(a_noRows, a_bandwidth, a_bands, a_x, a_y, j);
+		}
+		/******************************************************************************
+		 * legendreBasis_avx512
+		 *
+		 * @details    As legendreBasis_avx2, eight points at a time, with the
+		 * 				last points masked rather than left to scalar loops.
+		 ******************************************************************************/
+		__attribute__((target("avx512f")))
+		void legendreBasis_avx512(const int &a_p, const int &a_i, const int &a_m, const double a_x[], double a_P[], double a_values[])
+		{
+			const int N = a_p + 1;
+			const int m = a_m;
+
+			std::fill(a_P, a_P + m, 1.0);
+			if (a_p >= 1)
+				std::copy(a_x, a_x + m, a_P + m);
+			for (int n=2; n<=a_p; ++n)
+			{
+				double*       P_n  = &a_P[n*m];
+				const double* P_n1 = &a_P[(n-1)*m];
+				const double* P_n2 = &a_P[(n-2)*m];
+
+				__m512d a = _mm512_set1_pd(2*n-1);
+				__m512d b = _mm512_set1_pd(n-1);
+				__m512d c = _mm512_set1_pd(n);
+				for (int k=0; k<m; k+=8)
+				{
+					__mmask8 mask = (m-k >= 8)?0xFF:(1u << (m-k)) - 1;
+
+					__m512d term = _mm512_fmsub_pd(_mm512_mul_pd(a, _mm512_maskz_loadu_pd(mask, a_x + k)), _mm512_maskz_loadu_pd(mask, P_n1 + k), _mm512_mul_pd(b, _mm512_maskz_loadu_pd(mask, P_n2 + k)));
+					_mm512_mask_storeu_pd(P_n + k, mask, _mm512_div_pd(term, c));
+				}
+			}
+
+			for (int j=1; j<=a_i; ++j)
+			{
+				double*       P_j  = &a_P[j*N*m];
+				const double* P_j_ = &a_P[(j-1)*N*m];
+
+				std::fill(P_j, P_j + m, 0.0);
+				if (a_p >= 1)
+					std::fill(P_j + m, P_j + 2*m, (j==1)?1.0:0.0);
+				for (int n=2; n<=a_p; ++n)
+				{
+					__m512d a = _mm512_set1_pd(2*n-1);
+					for (int k=0; k<m; k+=8)
+					{
+						__mmask8 mask = (m-k >= 8)?0xFF:(1u << (m-k)) - 1;
+
+						_mm512_mask_storeu_pd(P_j + n*m + k, mask, _mm512_fmadd_pd(a, _mm512_maskz_loadu_pd(mask, P_j_ + (n-1)*m + k), _mm512_maskz_loadu_pd(mask, P_j + (n-2)*m + k)));
+					}
+				}
+			}
+
+			const __m512d one  = _mm512_set1_pd(1);
+			const __m512d two  = _mm512_set1_pd(2);
+			const __m512d half = _mm512_set1_pd(0.5);
+			for (int j=0; j<=a_i; ++j)
+			{
+				double*       row = &a_values[j*N*m];
+				const double* P_j = &a_P[j*N*m];
+
+				for (int k=0; k<m; k+=8)
+				{
+					__mmask8 mask = (m-k >= 8)?0xFF:(1u << (m-k)) - 1;
+
+					__m512d  x      = _mm512_maskz_loadu_pd(mask, a_x + k);
+					__mmask8 inside = _mm512_cmp_pd_mask(x, _mm512_set1_pd(-1), _CMP_GE_OQ) & _mm512_cmp_pd_mask(x, one, _CMP_LE_OQ);
+
+					__m512d left  = (j==0)?_mm512_div_pd(_mm512_sub_pd(one, x), two):(j==1)?_mm512_set1_pd(-0.5):_mm512_setzero_pd();
+					__m512d right = (j==0)?_mm512_div_pd(_mm512_add_pd(one, x), two):(j==1)?half:_mm512_setzero_pd();
+					_mm512_mask_storeu_pd(row + k, mask, _mm512_maskz_mov_pd(inside, left));
+					if (a_p >= 1)
+						_mm512_mask_storeu_pd(row + m + k, mask, _mm512_maskz_mov_pd(inside, right));
+				}
+
+				for (int a=2; a<=a_p; ++a)
+				{
+					__m512d c = _mm512_set1_pd(sqrt(double(a-1)-0.5));
+					for (int k=0; k<m; k+=8)
+					{
+						__mmask8 mask = (m-k >= 8)?0xFF:(1u << (m-k)) - 1;
+
+						__m512d difference = _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, P_j + a*m + k), _mm512_maskz_loadu_pd(mask, P_j + (a-2)*m + k));
+						_mm512_mask_storeu_pd(row + a*m + k, mask, _mm512_mul_pd(c, difference));
+					}
+				}
+			}
+		}
+#endif
+
+		// The instruction set in use; starts as the best one supported.
+		InstructionSet& current()
+		{
+			static InstructionSet instructionSet = get_supportedInstructionSet();
+
+			return instructionSet;
+		}
+	}
+
+	/******************************************************************************
+	 * get_supportedInstructionSet
+	 *
+	 * @details    Asks the processor for the best instruction set the kernels
+	 * 				have a version for.
+	 ******************************************************************************/
+	InstructionSet get_supportedInstructionSet()
+	{
+#ifdef KERNELS_X86
+		__builtin_cpu_init();
+
+		if (__builtin_cpu_supports("avx512f"))
+			return AVX512;
+		if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+			return AVX2;
+#endif
+
+		return Scalar;
+	}
+
+	InstructionSet get_instructionSet()
+	{
+		return current();
+	}
+
+	/******************************************************************************
+	 * set_instructionSet
+	 *
+	 * @details    Chooses which versions of the kernels to use, e.g. to compare
+	 * 				them. Requests for unsupported instruction sets fall back to
+	 * 				the best supported one.
+	 *
+	 * @param[in] a_instructionSet 	The instruction set to use.
+	 ******************************************************************************/
+	void set_instructionSet(const InstructionSet &a_instructionSet)
+	{
+		current() = std::min(a_instructionSet, get_supportedInstructionSet());
+	}
+
+	/******************************************************************************
+	 * csrMultiply
+	 *
+	 * @details    Calculates y = Ax for a matrix in CSR form.
+	 *
+	 * @param[in] a_noRows 		The number of rows.
+	 * @param[in] a_rowStarts 	Where each row starts, with the number of
+	 * 							 nonzeros appended.
+	 * @param[in] a_columnNos 	The column of each entry.
+	 * @param[in] a_entries 	The value of each entry.
+	 * @param[in] a_x 			The vector to multiply.
+	 * @param[out] a_y 			The product.
+	 ******************************************************************************/
+	void csrMultiply(const int &a_noRows, const int a_rowStarts[], const int a_columnNos[], const double a_entries[], const double a_x[], double a_y[])
+	{
+		// Rows too short to fill a vector would only pay for the reductions.
+		int averageRowLength = (a_noRows > 0)?a_rowStarts[a_noRows]/a_noRows:0;
+		InstructionSet instructionSet = current();
+		if (averageRowLength < 8)
+			instructionSet = std::min(instructionSet, AVX2);
+		if (averageRowLength < 4)
+			instructionSet = Scalar;
+
+		switch (instructionSet)
+		{
+#ifdef KERNELS_X86
+			case AVX512:
+				csrMultiply_avx512(a_noRows, a_rowStarts, a_columnNos, a_entries, a_x, a_y);
+				break;
+			case AVX2:
+				csrMultiply_avx2(a_noRows, a_rowStarts, a_columnNos, a_entries, a_x, a_y);
+				break;
+#endif
+			default:
+				csrMultiply_scalar(a_noRows, a_rowStarts, a_columnNos, a_entries, a_x, a_y);
+		}
+	}
+
+	/******************************************************************************
+	 * bandedMultiply
+	 *
+	 * @details    Calculates y = Ax for a symmetric banded matrix stored as
+	 * 				Matrix_banded stores it: its upper band by rows, where
+	 * 				a_bands[j*(w+1) + (i-j)] is the entry in column i and row j
+	 * 				for j <= i <= j+w. Positions past the last row are not read.
+	 *
+	 * @param[in] a_noRows 		The number of rows.
+	 * @param[in] a_bandwidth 	The half-bandwidth w.
+	 * @param[in] a_bands 		The entries of the upper band.
+	 * @param[in] a_x 			The vector to multiply.
+	 * @param[out] a_y 			The product.
+	 ******************************************************************************/
+	void bandedMultiply(const int &a_noRows, const int &a_bandwidth, const double a_bands[], const double a_x[], double a_y[])
+	{
+		std::fill(a_y, a_y + a_noRows, 0.0);
+
+		// Consecutive rows update overlapping stretches of y, and with fewer
+		//  than 16 entries per row off the diagonal waiting on those stores
+		//  costs as much as the vectors save. Bands that fit in a register
+		//  keep those updates there instead; a band of one is as fast scalar.
+		InstructionSet instructionSet = current();
+		if (a_bandwidth < 2 || (a_bandwidth > 8 && a_bandwidth < 16))
+			instructionSet = Scalar;
+		if (instructionSet == AVX2 && a_bandwidth > 4 && a_bandwidth < 16)
+			instructionSet = Scalar;
+
+		switch (instructionSet)
+		{
+#ifdef KERNELS_X86
+			case AVX512:
+				if (a_bandwidth <= 8)
+					narrowBandedMultiply_avx512(a_noRows, a_bandwidth, a_bands, a_x, a_y);
+				else
+					bandedMultiply_avx512(a_noRows, a_bandwidth, a_bands, a_x, a_y);
+				break;
+			case AVX2:
+				if (a_bandwidth <= 4)
+					narrowBandedMultiply_avx2(a_noRows, a_bandwidth, a_bands, a_x, a_y);
+				else
+					bandedMultiply_avx2(a_noRows, a_bandwidth, a_bands, a_x, a_y);
+				break;
+#endif
+			default:
+				bandedMultiply_scalar(a_noRows, a_bandwidth, a_bands, a_x, a_y);
+		}
+	}
+
+	/******************************************************************************
+	 * legendreBasis
+	 *
+	 * @details    Evaluates the derivatives 0..i of the shape functions of a
+	 * 				degree p element at m points: the vertex functions and
+	 * 				sqrt(a-3/2)*(P_a - P_{a-2}) for a >= 2, from the Legendre
+	 * 				recurrences run across the points.
+	 *
+	 * @param[in] a_p 		The polynomial degree.
+	 * @param[in] a_i 		The highest derivative.
+	 * @param[in] a_m 		The number of points.
+	 * @param[in] a_x 		The points.
+	 * @param[out] a_P 		Scratch space for (i+1)*(p+1)*m values, left with
+	 * 						 the jth derivative of P_n at the kth point at
+	 * 						 a_P[(j*(p+1) + n)*m + k].
+	 * @param[out] a_values The shape functions, laid out as a_P.
+	 ******************************************************************************/
+	void legendreBasis(const int &a_p, const int &a_i, const int &a_m, const double a_x[], double a_P[], double a_values[])
+	{
+		// With few points the masked tails cost more than wider vectors save.
+		InstructionSet instructionSet = current();
+		if (a_m < 16)
+			instructionSet = std::min(instructionSet, AVX2);
+		if (a_m < 4)
+			instructionSet = Scalar;
+
+		switch (instructionSet)
+		{
+#ifdef KERNELS_X86
+			case AVX512:
+				legendreBasis_avx512(a_p, a_i, a_m, a_x, a_P, a_values);
+				break;
+			case AVX2:
+				legendreBasis_avx2(a_p, a_i, a_m, a_x, a_P, a_values);
+				break;
+#endif
+			default:
+				legendreBasis_scalar(a_p, a_i, a_m, a_x, a_P, a_values);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+/******************************************************************************
+ * @details This is a file containing declarations of the [kernels] namespace.
+ *
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/14
+ ******************************************************************************/
+#ifndef NAMESPACE_KERNELS
+#define NAMESPACE_KERNELS
+
+namespace kernels
+{
+	// Instruction sets the kernels have versions for, in order of preference.
+	enum InstructionSet {Scalar, AVX2, AVX512};
+
+	InstructionSet get_instructionSet();
+	InstructionSet get_supportedInstructionSet();
+	void           set_instructionSet(const InstructionSet &a_instructionSet);
+
+	void csrMultiply(const int &a_noRows, const int a_rowStarts[], const int a_columnNos[], const double a_entries[], const double a_x[], double a_y[]);
+	void bandedMultiply(const int &a_noRows, const int &a_bandwidth, const double a_bands[], const double a_x[], double a_y[]);
+	void legendreBasis(const int &a_p, const int &a_i, const int &a_m, const double a_x[], double a_P[], double a_values[]);
+}
+
+#endif
\ No newline at end of file
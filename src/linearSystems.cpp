@@ -8,7 +8,9 @@
  ******************************************************************************/
 
 #include "linearSystems.hpp"
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <vector>
 
 #include <iostream>
@@ -51,33 +53,325 @@ namespace linearSystems
 		}
 	}
 
+	namespace
+	{
+		/******************************************************************************
+		 * conjugateGradient_impl
+		 * 
+		 * @details    Preconditioned conjugate gradient, instantiated for each
+		 * 				storage so that the matrix-vector product binds statically
+		 * 				to its multiply kernel; only the Matrix<double> and
+		 * 				Operator versions dispatch, and then once per product.
+		 * 				Without a preconditioner this is plain CG. Iterates from
+		 * 				x0, or from zero if x0 is empty, until a rule of the
+		 * 				criteria says to stop. The vectors are updated in place in
+		 * 				the workspace, so only the solution is allocated once the
+		 * 				workspace has grown.
+		 * 
+		 * 				The energy norm of the error in x_k is estimated by the sum
+		 * 				of alpha_j r_j.z_j for j = k, ..., k+d-1, which is a lower
+		 * 				bound that sharpens quickly with the delay d (Hestenes and
+		 * 				Stiefel). It is known d iterations late, when x is already
+		 * 				more accurate than the estimate says.
+		 *
+		 * 				With the stagnation rule on, the iterate with the smallest
+		 * 				residual is kept, and returned if CG stagnates or runs out
+		 * 				of iterations.
+		 ******************************************************************************/
+		template<class MatrixType>
+		std::vector<double> conjugateGradient_impl(const MatrixType &a_M, const Preconditioner* const &a_preconditioner, const std::vector<double> &a_b, const std::vector<double> &a_x0, const StoppingCriteria &a_criteria, Workspace &a_workspace, Statistics &a_statistics)
+		{
+			auto start = std::chrono::steady_clock::now();
+
+			std::vector<double> &r = a_workspace.r;
+			std::vector<double> &z = a_workspace.z;
+			std::vector<double> &p = a_workspace.p;
+			std::vector<double> &q = a_workspace.q;
+			r = a_b;
+
+			std::vector<double> x;
+			if (a_x0.empty())
+				x.assign(a_M.get_noColumns(), 0);
+			else
+			{
+				x = a_x0;
+				a_M.multiply(x, q);
+				axpy(-1, q, r);
+			}
+
+			// Without a preconditioner z is just r.
+			const std::vector<double> &z_ = (a_preconditioner != 0)?z:r;
+			if (a_preconditioner != 0)
+				a_preconditioner->apply(r, z);
+
+			p = z_;
+
+			double r_z = dotProduct(r, z_);
+			double errorNorm = sqrt(dotProduct(r, r));
+
+			double tolerance = std::max(a_criteria.absoluteTolerance, a_criteria.relativeTolerance*errorNorm);
+
+			// The last d terms of the error estimate, in a ring.
+			int delay = std::max(a_criteria.estimateDelay, 1);
+			std::vector<double> &errorTerms = a_workspace.errorTerms;
+			errorTerms.assign(delay, 0);
+			double errorEstimate2 = 0;
+
+			double smallestNorm = errorNorm;
+			int lastDecrease = 0;
+
+			bool keepBest = a_criteria.stagnationIterations > 0;
+			std::vector<double> &best = a_workspace.best;
+			if (keepBest)
+				best = x;
+
+			StoppingReason stoppingReason = Converged;
+			int noIterations = 0;
+
+			while(errorNorm > tolerance)
+			{
+				if (noIterations >= delay && a_criteria.energyTolerance > 0 && sqrt(errorEstimate2) <= a_criteria.energyTolerance)
+					break;
+				if (a_criteria.maxIterations > 0 && noIterations >= a_criteria.maxIterations)
+				{
+					stoppingReason = MaxIterations;
+					break;
+				}
+				if (a_criteria.stagnationIterations > 0 && noIterations - lastDecrease >= a_criteria.stagnationIterations)
+				{
+					stoppingReason = Stagnated;
+					break;
+				}
+
+				a_M.multiply(p, q);
+				double alpha = r_z/dotProduct(p, q);
+				axpy(alpha, p, x);
+
+				double &errorTerm = errorTerms[noIterations % delay];
+				errorEstimate2 += alpha*r_z - errorTerm;
+				errorTerm = alpha*r_z;
+
+				double r_zNew;
+				if (a_preconditioner != 0)
+				{
+					axpy(-alpha, q, r);
+					a_preconditioner->apply(r, z);
+					r_zNew = dotProduct(r, z);
+					errorNorm = sqrt(dotProduct(r, r));
+				}
+				else
+				{
+					r_zNew = axpyDot(-alpha, q, r);
+					errorNorm = sqrt(r_zNew);
+				}
+
+				double beta = r_zNew/r_z;
+
+				r_z = r_zNew;
+				xpay(z_, beta, p);
+				++noIterations;
+
+				if (errorNorm < smallestNorm)
+				{
+					smallestNorm = errorNorm;
+					lastDecrease = noIterations;
+					if (keepBest)
+						best = x;
+				}
+			}
+
+			if (keepBest && stoppingReason != Converged && smallestNorm < errorNorm)
+			{
+				x.swap(best);
+				errorNorm = smallestNorm;
+			}
+
+			a_statistics.noIterations   = noIterations;
+			a_statistics.residualNorm   = errorNorm;
+			a_statistics.solveTime      = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			a_statistics.stoppingReason = stoppingReason;
+			a_statistics.errorEstimate  = (noIterations >= delay)?sqrt(std::max(errorEstimate2, 0.0)):NAN;
+
+			return x;
+		}
+
+		StoppingCriteria absolute(const double &a_tolerance)
+		{
+			StoppingCriteria criteria;
+			criteria.absoluteTolerance = a_tolerance;
+
+			return criteria;
+		}
+	}
+
 	std::vector<double> conjugateGradient(const Matrix<double> &a_M, const std::vector<double> &a_b, const double &a_tolerance)
 	{
-		std::vector<double> x(a_M.get_noColumns(), 0);
+		Workspace  workspace;
+		Statistics statistics;
+		return conjugateGradient_impl(a_M, 0, a_b, {}, absolute(a_tolerance), workspace, statistics);
+	}
 
-		std::vector<double> r = a_b;
-		std::vector<double> p = a_b;
+	std::vector<double> conjugateGradient(const Matrix_full<double> &a_M, const std::vector<double> &a_b, const double &a_tolerance)
+	{
+		Workspace  workspace;
+		Statistics statistics;
+		return conjugateGradient_impl(a_M, 0, a_b, {}, absolute(a_tolerance), workspace, statistics);
+	}
 
-		double r_2 = dotProduct(r, r);
-		double errorNorm = sqrt(r_2);
+	std::vector<double> conjugateGradient(const Matrix_sparse<double> &a_M, const std::vector<double> &a_b, const double &a_tolerance)
+	{
+		Workspace  workspace;
+		Statistics statistics;
+		return conjugateGradient_impl(a_M, 0, a_b, {}, absolute(a_tolerance), workspace, statistics);
+	}
 
+	std::vector<double> conjugateGradient(const Operator &a_operator, const std::vector<double> &a_b, const double &a_tolerance)
+	{
+		Workspace  workspace;
+		Statistics statistics;
+		return conjugateGradient_impl(a_operator, 0, a_b, {}, absolute(a_tolerance), workspace, statistics);
+	}
+
+	/******************************************************************************
+	 * preconditionedConjugateGradient
+	 * 
+	 * @details    Solves Ax = b by CG preconditioned with M.
+	 *
+	 * @param[in] a_matrix 			A.
+	 * @param[in] a_preconditioner 	M, or 0 for none.
+	 * @param[in] a_b 				b.
+	 * @param[in] a_tolerance 		The largest 2-norm of the residual allowed.
+	 * @param[out] a_statistics 	The iterations, final residual and time
+	 * 								 taken; the setup time is left alone.
+	 * @return 						x.
+	 ******************************************************************************/
+	std::vector<double> preconditionedConjugateGradient(const Matrix_sparse<double> &a_matrix, const Preconditioner* const &a_preconditioner, const std::vector<double> &a_b, const double &a_tolerance, Statistics &a_statistics)
+	{
+		Workspace workspace;
+		return conjugateGradient_impl(a_matrix, a_preconditioner, a_b, {}, absolute(a_tolerance), workspace, a_statistics);
+	}
+
+	std::vector<double> preconditionedConjugateGradient(const Operator &a_operator, const Preconditioner* const &a_preconditioner, const std::vector<double> &a_b, const double &a_tolerance, Statistics &a_statistics)
+	{
+		Workspace workspace;
+		return conjugateGradient_impl(a_operator, a_preconditioner, a_b, {}, absolute(a_tolerance), workspace, a_statistics);
+	}
+
+	/******************************************************************************
+	 * preconditionedConjugateGradient
+	 * 
+	 * @details    As above, starting from an initial guess, stopping by the
+	 * 				given criteria and working in the given workspace, which is
+	 * 				reused from one solve to the next, e.g. by each Newton
+	 * 				iteration.
+	 *
+	 * @param[in] a_x0 				The initial guess, or empty for zero.
+	 * @param[in] a_criteria 		When to stop.
+	 * @param[in,out] a_workspace 	The vectors to work in.
+	 ******************************************************************************/
+	std::vector<double> preconditionedConjugateGradient(const Matrix_sparse<double> &a_matrix, const Preconditioner* const &a_preconditioner, const std::vector<double> &a_b, const std::vector<double> &a_x0, const StoppingCriteria &a_criteria, Workspace &a_workspace, Statistics &a_statistics)
+	{
+		return conjugateGradient_impl(a_matrix, a_preconditioner, a_b, a_x0, a_criteria, a_workspace, a_statistics);
+	}
+
+	std::vector<double> preconditionedConjugateGradient(const Operator &a_operator, const Preconditioner* const &a_preconditioner, const std::vector<double> &a_b, const std::vector<double> &a_x0, const StoppingCriteria &a_criteria, Workspace &a_workspace, Statistics &a_statistics)
+	{
+		return conjugateGradient_impl(a_operator, a_preconditioner, a_b, a_x0, a_criteria, a_workspace, a_statistics);
+	}
+
+	/******************************************************************************
+	 * iterativeRefinement
+	 * 
+	 * @details    Solves Ax = b by iterative refinement with an approximate
+	 * 				solver M: x += M^{-1}(b - Ax). The residual and the
+	 * 				corrections are in double, so with M a factorisation of A
+	 * 				in float the solution reaches double accuracy in a few
+	 * 				steps, as long as the condition number of A is well below
+	 * 				1/(float epsilon). Nearer to that each step gains less, and
+	 * 				the refinement stops as Stagnated at the first step that
+	 * 				does not halve the residual, having undone it if it made
+	 * 				the residual larger. The criteria's energy tolerance is not
+	 * 				used.
+	 *
+	 * @param[in] a_matrix 			A.
+	 * @param[in] a_solver 			M.
+	 * @param[in] a_b 				b.
+	 * @param[in] a_x0 				The initial guess, or empty for zero.
+	 * @param[in] a_criteria 		When to stop.
+	 * @param[in,out] a_workspace 	The vectors to work in.
+	 * @param[out] a_statistics 	The steps, final residual and time taken;
+	 * 								 the setup time is left alone.
+	 * @return 						x.
+	 ******************************************************************************/
+	std::vector<double> iterativeRefinement(const Matrix_sparse<double> &a_matrix, const Preconditioner* const &a_solver, const std::vector<double> &a_b, const std::vector<double> &a_x0, const StoppingCriteria &a_criteria, Workspace &a_workspace, Statistics &a_statistics)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		std::vector<double> &r = a_workspace.r;
+		std::vector<double> &z = a_workspace.z;
+		std::vector<double> &q = a_workspace.q;
+		r = a_b;
+
+		std::vector<double> x;
+		if (a_x0.empty())
+			x.assign(a_matrix.get_noColumns(), 0);
+		else
+		{
+			x = a_x0;
+			a_matrix.multiply(x, q);
+			axpy(-1, q, r);
+		}
+
+		double errorNorm = sqrt(dotProduct(r, r));
+		double tolerance = std::max(a_criteria.absoluteTolerance, a_criteria.relativeTolerance*errorNorm);
+
+		StoppingReason stoppingReason = Converged;
 		int noIterations = 0;
 
-		while(errorNorm > a_tolerance)
+		while (errorNorm > tolerance)
 		{
-			std::vector<double> pNew = a_M * p;
-			double alpha = r_2/dotProduct(p, pNew);
-			x += alpha * p;
-			r += -alpha * pNew;
-			double r_2New = dotProduct(r, r);
-			double beta = r_2New/r_2;
-
-			r_2 = r_2New;
-			p = r + beta*p;
-			errorNorm = sqrt(r_2);
+			if (a_criteria.maxIterations > 0 && noIterations >= a_criteria.maxIterations)
+			{
+				stoppingReason = MaxIterations;
+				break;
+			}
+
+			a_solver->apply(r, z);
+			axpy(1, z, x);
+
+			r = a_b;
+			a_matrix.multiply(x, q);
+			double errorNormNew = sqrt(axpyDot(-1, q, r));
 			++noIterations;
+
+			if (errorNormNew >= errorNorm)
+			{
+				// Undoes the step that made things worse.
+				axpy(-1, z, x);
+				r = a_b;
+				a_matrix.multiply(x, q);
+				axpy(-1, q, r);
+
+				stoppingReason = Stagnated;
+				break;
+			}
+
+			// Steps this slow are better spent on CG.
+			bool slow = errorNormNew > errorNorm/2;
+			errorNorm = errorNormNew;
+			if (slow && errorNorm > tolerance)
+			{
+				stoppingReason = Stagnated;
+				break;
+			}
 		}
 
+		a_statistics.noIterations   = noIterations;
+		a_statistics.residualNorm   = errorNorm;
+		a_statistics.solveTime      = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		a_statistics.stoppingReason = stoppingReason;
+		a_statistics.errorEstimate  = NAN;
+
 		return x;
 	}
 
@@ -90,6 +384,46 @@ namespace linearSystems
 
 		return result;
 	}
+
+	/******************************************************************************
+	 * axpy
+	 * 
+	 * @details    y += alpha x, in place.
+	 ******************************************************************************/
+	void axpy(const double &a_alpha, const std::vector<double> &a_x, std::vector<double> &a_y)
+	{
+		for (int i=0; i<a_y.size(); ++i)
+			a_y[i] += a_alpha * a_x[i];
+	}
+
+	/******************************************************************************
+	 * axpyDot
+	 * 
+	 * @details    y += alpha x, in place, returning y.y in the same pass.
+	 ******************************************************************************/
+	double axpyDot(const double &a_alpha, const std::vector<double> &a_x, std::vector<double> &a_y)
+	{
+		double result = 0;
+
+		for (int i=0; i<a_y.size(); ++i)
+		{
+			a_y[i] += a_alpha * a_x[i];
+			result += a_y[i] * a_y[i];
+		}
+
+		return result;
+	}
+
+	/******************************************************************************
+	 * xpay
+	 * 
+	 * @details    y = x + beta y, in place.
+	 ******************************************************************************/
+	void xpay(const std::vector<double> &a_x, const double &a_beta, std::vector<double> &a_y)
+	{
+		for (int i=0; i<a_y.size(); ++i)
+			a_y[i] = a_x[i] + a_beta * a_y[i];
+	}
 }
 
 std::vector<double>& operator+=(std::vector<double> &a_v1, const std::vector<double> &a_v2)
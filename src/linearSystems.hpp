@@ -8,6 +8,10 @@
 #define NAMESPACE_LINEARSYSTEMS
 
 #include "matrix.hpp"
+#include "matrix_full.hpp"
+#include "matrix_sparse.hpp"
+#include "operator.hpp"
+#include "preconditioner.hpp"
 #include <cmath>
 #include <functional>
 #include <vector>
@@ -16,9 +20,65 @@ typedef std::function<double(double)> f_double;
 
 namespace linearSystems
 {
+	// Preconditioners for preconditionedConjugateGradient.
+	enum Preconditioning {None, Jacobi, BlockJacobi, IncompleteCholesky, Multigrid};
+
+	// Multigrid cycles, by how many times each level visits the next
+	//  coarser one.
+	enum Cycle {VCycle = 1, WCycle = 2};
+
+	// Why conjugateGradient stopped.
+	enum StoppingReason {Converged, MaxIterations, Stagnated};
+
+	// When conjugateGradient stops; zero switches a rule off. It has
+	//  converged once any of the tolerances is met.
+	struct StoppingCriteria
+	{
+		double absoluteTolerance    = 0; // On the 2-norm of the residual.
+		double relativeTolerance    = 0; // The same, relative to the first residual.
+		double energyTolerance      = 0; // On the estimated energy norm of the error.
+		int    maxIterations        = 0;
+		int    stagnationIterations = 0; // Iterations without a new smallest residual.
+		int    estimateDelay        = 4; // Iterations the error estimate looks ahead.
+	};
+
+	// What a solve cost, with times in seconds.
+	struct Statistics
+	{
+		int    noIterations;
+		double residualNorm;
+		double setupTime;
+		double solveTime;
+		StoppingReason stoppingReason;
+		double errorEstimate; // Energy norm of the error, if it was estimated.
+	};
+
+	// Vectors for conjugateGradient to work in. Kept by the caller, they
+	//  are only allocated by the first solve of each size.
+	struct Workspace
+	{
+		std::vector<double> r;
+		std::vector<double> z;
+		std::vector<double> p;
+		std::vector<double> q;
+		std::vector<double> errorTerms;
+		std::vector<double> best;
+	};
+
 	void thomasInvert(const std::vector<double> a, const std::vector<double> b, const std::vector<double> c, const std::vector<double> d, std::vector<double> &solution);
 	std::vector<double> conjugateGradient(const Matrix<double> &a_matrix, const std::vector<double> &a_b, const double &a_tolerance);
+	std::vector<double> conjugateGradient(const Matrix_full<double> &a_matrix, const std::vector<double> &a_b, const double &a_tolerance);
+	std::vector<double> conjugateGradient(const Matrix_sparse<double> &a_matrix, const std::vector<double> &a_b, const double &a_tolerance);
+	std::vector<double> conjugateGradient(const Operator &a_operator, const std::vector<double> &a_b, const double &a_tolerance);
+	std::vector<double> preconditionedConjugateGradient(const Matrix_sparse<double> &a_matrix, const Preconditioner* const &a_preconditioner, const std::vector<double> &a_b, const double &a_tolerance, Statistics &a_statistics);
+	std::vector<double> preconditionedConjugateGradient(const Operator &a_operator, const Preconditioner* const &a_preconditioner, const std::vector<double> &a_b, const double &a_tolerance, Statistics &a_statistics);
+	std::vector<double> preconditionedConjugateGradient(const Matrix_sparse<double> &a_matrix, const Preconditioner* const &a_preconditioner, const std::vector<double> &a_b, const std::vector<double> &a_x0, const StoppingCriteria &a_criteria, Workspace &a_workspace, Statistics &a_statistics);
+	std::vector<double> preconditionedConjugateGradient(const Operator &a_operator, const Preconditioner* const &a_preconditioner, const std::vector<double> &a_b, const std::vector<double> &a_x0, const StoppingCriteria &a_criteria, Workspace &a_workspace, Statistics &a_statistics);
+	std::vector<double> iterativeRefinement(const Matrix_sparse<double> &a_matrix, const Preconditioner* const &a_solver, const std::vector<double> &a_b, const std::vector<double> &a_x0, const StoppingCriteria &a_criteria, Workspace &a_workspace, Statistics &a_statistics);
 	double dotProduct(const std::vector<double> &a_v1, const std::vector<double> &a_v2);
+	void   axpy(const double &a_alpha, const std::vector<double> &a_x, std::vector<double> &a_y);
+	double axpyDot(const double &a_alpha, const std::vector<double> &a_x, std::vector<double> &a_y);
+	void   xpay(const std::vector<double> &a_x, const double &a_beta, std::vector<double> &a_y);
 }
 
 std::vector<double> operator*(const double &a_constant, const std::vector<double> &a_vector);
@@ -152,6 +152,27 @@ Matrix<T>& Matrix<T>::operator*=(const T &a_RHS)
 	return *this;
 }
 
+/******************************************************************************
+ * __multiply__
+ * 
+ * @details 	Calculates y = Ax. This generic version goes through item() for
+ * 				every entry; each storage overrides it with a kernel that only
+ * 				touches its own arrays, so a product costs one virtual call
+ * 				rather than one per entry.
+ * 
+ * @param[in] a_x 		The vector to multiply.
+ * @param[out] a_y 		The product, resized to the number of rows.
+ ******************************************************************************/
+template<class T>
+void Matrix<T>::multiply(const std::vector<T> &a_x, std::vector<T> &a_y) const
+{
+	a_y.assign(get_noRows(), 0);
+
+	for (int j=0; j<get_noRows(); ++j)
+		for (int i=0; i<get_noColumns(); ++i)
+			a_y[j] += item(i, j) * a_x[i];
+}
+
 /******************************************************************************
  * __operator*__
  * 
@@ -166,10 +187,8 @@ std::vector<T> Matrix<T>::operator*(const std::vector<T> &a_RHS) const
 		return a_RHS;
 	}
 
-	std::vector<T> tempVector(get_noColumns(), 0);
-	for (int i=0; i<get_noColumns(); ++i)
-		for (int j=0; j<get_noRows(); ++j)
-			tempVector[i] += item(i, j) * a_RHS[j];
+	std::vector<T> tempVector;
+	multiply(a_RHS, tempVector);
 
 	return tempVector;
 }
@@ -43,6 +43,7 @@ class Matrix
 		Matrix<T>& operator/=(const T &a_RHS);
 
 		// Matrix-vector operations.
+		virtual void   multiply(const std::vector<T> &a_x, std::vector<T> &a_y) const;
 		std::vector<T> operator*(const std::vector<T> &a_RHS) const;
 };
 
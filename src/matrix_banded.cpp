@@ -0,0 +1,360 @@
+/******************************************************************************
+ * @details This is a file containing definitions of [Matrix_banded].
+ * 
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/21
+ ******************************************************************************/
+#ifndef CLASS_SRC_MATRIX_BANDED
+#define CLASS_SRC_MATRIX_BANDED
+
+#include "kernels.hpp"
+#include "matrix.hpp"
+#include "matrix_banded.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <type_traits>
+
+/******************************************************************************
+ * __Matrix_banded__
+ * 
+ * @details 	A zero symmetric matrix with the given half-bandwidth.
+ * 
+ * @param[in] a_noRows 		The number of rows (and columns).
+ * @param[in] a_bandwidth 	The half-bandwidth w; entries with |i-j| > w are
+ * 							 zero.
+ ******************************************************************************/
+template<class T>
+Matrix_banded<T>::Matrix_banded(const int &a_noRows, const int &a_bandwidth)
+{
+	this->noRows     = a_noRows;
+	this->bandwidth  = a_bandwidth;
+	this->factorised = false;
+	this->resize(a_noRows*(a_bandwidth+1));
+}
+
+/******************************************************************************
+ * __Matrix_banded__
+ * 
+ * @details 	Converts any symmetric matrix, taking the bandwidth from its
+ * 				upper triangle; the lower triangle is not read.
+ * 
+ * @param[in] a_matrix 	The matrix to convert.
+ ******************************************************************************/
+template<class T>
+Matrix_banded<T>::Matrix_banded(const Matrix<T> &a_matrix)
+{
+	assert(a_matrix.get_noRows() == a_matrix.get_noColumns());
+
+	int n = a_matrix.get_noRows();
+	int w = 0;
+	for (int j=0; j<n; ++j)
+		for (int i=j; i<n; ++i)
+			if (a_matrix(i, j) != 0)
+				w = std::max(w, i-j);
+
+	this->noRows     = n;
+	this->bandwidth  = w;
+	this->factorised = false;
+	this->resize(n*(w+1));
+
+	for (int j=0; j<n; ++j)
+		for (int i=j; i<=std::min(n-1, j+w); ++i)
+			this->bands[get_index(i, j)] = a_matrix(i, j);
+}
+
+/******************************************************************************
+ * __Matrix_banded__
+ * 
+ * @details 	Converts a symmetric sparse matrix, visiting only its stored
+ * 				entries. Its entries may be of another type, e.g. to store a
+ * 				double matrix in float.
+ * 
+ * @param[in] a_matrix 	The matrix to convert.
+ ******************************************************************************/
+template<class T>
+template<class S>
+Matrix_banded<T>::Matrix_banded(const Matrix_sparse<S> &a_matrix)
+{
+	assert(a_matrix.get_noRows() == a_matrix.get_noColumns());
+
+	const std::vector<int> &rowStarts     = a_matrix.get_rowStarts();
+	const std::vector<int> &columnNos     = a_matrix.get_columnNos();
+	const std::vector<S>   &matrixEntries = a_matrix.get_matrixEntries();
+
+	int n = a_matrix.get_noRows();
+	int w = 0;
+	for (int j=0; j<n; ++j)
+		for (int index=rowStarts[j]; index<rowStarts[j+1]; ++index)
+			if (matrixEntries[index] != 0)
+				w = std::max(w, columnNos[index]-j);
+
+	this->noRows     = n;
+	this->bandwidth  = w;
+	this->factorised = false;
+	this->resize(n*(w+1));
+
+	for (int j=0; j<n; ++j)
+		for (int index=rowStarts[j]; index<rowStarts[j+1]; ++index)
+			if (columnNos[index] >= j && matrixEntries[index] != 0)
+				this->bands[get_index(columnNos[index], j)] = T(matrixEntries[index]);
+}
+
+/******************************************************************************
+ * __resize__
+ * 
+ * @details 	
+ ******************************************************************************/
+template<class T>
+void Matrix_banded<T>::resize(const int &a_noNonZeros)
+{
+	this->bands.assign(a_noNonZeros, 0);
+	this->factorised = false;
+}
+
+/******************************************************************************
+ * __get_index__
+ * 
+ * @details 	Where an entry is stored, by symmetry for the lower triangle.
+ * 
+ * @param[in] a_x 	The column.
+ * @param[in] a_y 	The row.
+ * @return 			The index in bands, or -1 outside the band.
+ ******************************************************************************/
+template<class T>
+int Matrix_banded<T>::get_index(const int &a_x, const int &a_y) const
+{
+	int i = std::max(a_x, a_y);
+	int j = std::min(a_x, a_y);
+
+	if (i-j > this->bandwidth)
+		return -1;
+
+	return j*(this->bandwidth+1) + (i-j);
+}
+
+/******************************************************************************
+ * __item__
+ * 
+ * @details 	
+ ******************************************************************************/
+template<class T>
+const T Matrix_banded<T>::item(const int &a_x, const int &a_y) const
+{
+	assert(!this->factorised);
+
+	int index = get_index(a_x, a_y);
+
+	return (index < 0)?0:this->bands[index];
+}
+
+/******************************************************************************
+ * __multiply__
+ * 
+ * @details 	Calculates y = Ax, using each stored entry for both of its
+ * 				positions. The matrix must not have been factorised.
+ * 
+ * @param[in] a_x 		The vector to multiply.
+ * @param[out] a_y 		The product, resized to the number of rows.
+ ******************************************************************************/
+template<class T>
+void Matrix_banded<T>::multiply(const std::vector<T> &a_x, std::vector<T> &a_y) const
+{
+	assert(!this->factorised);
+
+	int n = this->noRows;
+	int w = this->bandwidth;
+	a_y.assign(n, 0);
+
+	// Vectorised kernels where available.
+	if constexpr (std::is_same<T, double>::value)
+	{
+		kernels::bandedMultiply(n, w, this->bands.data(), a_x.data(), a_y.data());
+		return;
+	}
+
+	for (int j=0; j<n; ++j)
+	{
+		const T* row = this->bands.data() + j*(w+1);
+		int width = std::min(w, n-1-j);
+
+		T sum = row[0]*a_x[j];
+		for (int k=1; k<=width; ++k)
+		{
+			sum      += row[k]*a_x[j+k];
+			a_y[j+k] += row[k]*a_x[j];
+		}
+
+		a_y[j] += sum;
+	}
+}
+
+/******************************************************************************
+ * __factorise__
+ * 
+ * @details 	Calculates A = U^T D U, with U unit upper triangular, in
+ * 				O(n w^2) operations and in place: U cannot fill in outside
+ * 				the band, so the factors overwrite it. Afterwards any number
+ * 				of right-hand sides can be solved with them, but the entries
+ * 				of A are gone. For w = 1 this is the elimination of
+ * 				linearSystems::thomasInvert. No pivoting is done, which is
+ * 				stable for symmetric positive definite matrices.
+ ******************************************************************************/
+template<class T>
+void Matrix_banded<T>::factorise()
+{
+	assert(!this->factorised);
+
+	int n = this->noRows;
+	int w = this->bandwidth;
+
+	for (int j=0; j<n; ++j)
+	{
+		T* row = this->bands.data() + j*(w+1);
+		int width = std::min(w, n-1-j);
+
+		T pivot = row[0];
+		assert(pivot != 0);
+
+		// Eliminates below the pivot; only the upper band of each later row
+		//  is stored, so row j+a is updated from column j+a onwards.
+		for (int a=1; a<=width; ++a)
+		{
+			if (row[a] == 0)
+				continue;
+
+			T multiplier = row[a]/pivot;
+			T* rowA = this->bands.data() + (j+a)*(w+1);
+
+			for (int b=a; b<=width; ++b)
+				rowA[b-a] -= multiplier*row[b];
+		}
+
+		for (int a=1; a<=width; ++a)
+			row[a] /= pivot;
+	}
+
+	this->factorised = true;
+}
+
+/******************************************************************************
+ * __solve__
+ * 
+ * @details 	Solves Ax = b with the factors from factorise.
+ * 
+ * @param[in] a_b 	The right-hand side.
+ * @return 			The solution.
+ ******************************************************************************/
+template<class T>
+std::vector<T> Matrix_banded<T>::solve(const std::vector<T> &a_b) const
+{
+	std::vector<T> x;
+	this->solve(a_b, x);
+
+	return x;
+}
+
+/******************************************************************************
+ * __solve__
+ * 
+ * @details 	Solves Ax = b with the factors from factorise, in O(n w)
+ * 				operations.
+ * 
+ * @param[in] a_b 		The right-hand side.
+ * @param[out] a_x 		The solution, resized to the number of rows.
+ ******************************************************************************/
+template<class T>
+void Matrix_banded<T>::solve(const std::vector<T> &a_b, std::vector<T> &a_x) const
+{
+	assert(this->factorised);
+	assert(int(a_b.size()) == this->noRows);
+
+	int n = this->noRows;
+	int w = this->bandwidth;
+	a_x = a_b;
+
+	// Solves U^T D y = b.
+	for (int j=0; j<n; ++j)
+	{
+		const T* row = this->bands.data() + j*(w+1);
+		int width = std::min(w, n-1-j);
+
+		for (int a=1; a<=width; ++a)
+			a_x[j+a] -= row[a]*a_x[j];
+
+		a_x[j] /= row[0];
+	}
+
+	// Solves U x = y.
+	for (int j=n-1; j>=0; --j)
+	{
+		const T* row = this->bands.data() + j*(w+1);
+		int width = std::min(w, n-1-j);
+
+		for (int a=1; a<=width; ++a)
+			a_x[j] -= row[a]*a_x[j+a];
+	}
+}
+
+/******************************************************************************
+ * __get_noRows__
+ * 
+ * @details 	
+ ******************************************************************************/
+template<class T>
+int Matrix_banded<T>::get_noRows() const
+{
+	return this->noRows;
+}
+
+/******************************************************************************
+ * __get_noColumns__
+ * 
+ * @details 	
+ ******************************************************************************/
+template<class T>
+int Matrix_banded<T>::get_noColumns() const
+{
+	return this->noRows;
+}
+
+template<class T>
+int Matrix_banded<T>::get_bandwidth() const
+{
+	return this->bandwidth;
+}
+
+template<class T>
+bool Matrix_banded<T>::get_factorised() const
+{
+	return this->factorised;
+}
+
+/******************************************************************************
+ * __set__
+ * 
+ * @details 	Sets an entry and, by symmetry, its transpose. Zeros outside
+ * 				the band are ignored; anything else there is an error. The
+ * 				matrix must not have been factorised.
+ * 
+ * @param[in] a_x 		The column.
+ * @param[in] a_y 		The row.
+ * @param[in] a_value 	The value.
+ ******************************************************************************/
+template<class T>
+void Matrix_banded<T>::set(const int &a_x, const int &a_y, const T &a_value)
+{
+	assert(!this->factorised);
+
+	int index = get_index(a_x, a_y);
+
+	if (index < 0)
+	{
+		assert(a_value == 0);
+		return;
+	}
+
+	this->bands[index] = a_value;
+}
+
+#endif
\ No newline at end of file
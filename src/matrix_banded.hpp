@@ -0,0 +1,67 @@
+/******************************************************************************
+ * @details Declarations for [Matrix_banded].
+ * 
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/21
+ ******************************************************************************/
+#ifndef CLASS_MATRIX_BANDED
+#define CLASS_MATRIX_BANDED
+
+#include "matrix.hpp"
+#include "matrix_sparse.hpp"
+#include <cassert>
+#include <vector>
+
+template<class T>
+class Matrix_banded: public Matrix<T>
+{
+	protected:
+		// Hidden default constructor.
+		Matrix_banded();
+
+		// Storage of the upper band, row by row: bands[j*(w+1) + (i-j)] is
+		//  the entry in column i and row j, for j <= i <= j+w. Once
+		//  factorised it holds the LDL^T factors instead, stored the same way
+		//  with D on the diagonal.
+		std::vector<T> bands;
+		int noRows;
+		int bandwidth;
+		bool factorised;
+
+		// Resizing.
+		void resize(const int &a_noNonZeros);
+
+		// Index calculation.
+		int get_index(const int &a_x, const int &a_y) const;
+
+		// Gets an individual item.
+		const T item(const int &a_x, const int &a_y) const;
+
+	public:
+		// Constructors.
+		Matrix_banded(const int &a_noRows, const int &a_bandwidth);
+		Matrix_banded(const Matrix<T> &a_matrix);
+		template<class S>
+		Matrix_banded(const Matrix_sparse<S> &a_matrix);
+
+		// Matrix-vector operations.
+		void multiply(const std::vector<T> &a_x, std::vector<T> &a_y) const final;
+
+		// Factorisation.
+		void           factorise();
+		std::vector<T> solve(const std::vector<T> &a_b) const;
+		void           solve(const std::vector<T> &a_b, std::vector<T> &a_x) const;
+
+		// Getters.
+		int  get_noRows() const;
+		int  get_noColumns() const;
+		int  get_bandwidth() const;
+		bool get_factorised() const;
+
+		// Setters.
+		void set(const int &a_x, const int &a_y, const T &a_value);
+};
+
+#include "matrix_banded.cpp"
+
+#endif
\ No newline at end of file
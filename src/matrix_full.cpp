@@ -230,6 +230,28 @@ Matrix_full<T> Matrix_full<T>::operator/(const T &a_RHS)
 	return tempMatrix;
 }
 
+/******************************************************************************
+ * __multiply__
+ * 
+ * @details 	Calculates y = Ax, walking the rows of the storage directly.
+ ******************************************************************************/
+template<class T>
+void Matrix_full<T>::multiply(const std::vector<T> &a_x, std::vector<T> &a_y) const
+{
+	a_y.assign(this->noRows, 0);
+
+	for (int j=0; j<this->noRows; ++j)
+	{
+		const T* row = &this->items[j*this->noColumns];
+		T sum = 0;
+
+		for (int i=0; i<this->noColumns; ++i)
+			sum += row[i] * a_x[i];
+
+		a_y[j] = sum;
+	}
+}
+
 /******************************************************************************
  * __get_noRows__
  * 
@@ -49,6 +49,9 @@ class Matrix_full: public Matrix<T>
 		Matrix_full<T> operator*(const T &a_RHS);
 		Matrix_full<T> operator/(const T &a_RHS);
 
+		// Matrix-vector operations.
+		void multiply(const std::vector<T> &a_x, std::vector<T> &a_y) const final;
+
 		// Getters.
 		int get_noRows() const;
 		int get_noColumns() const;
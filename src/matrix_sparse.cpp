@@ -7,10 +7,13 @@
 #ifndef CLASS_SRC_MATRIX_SPARSE
 #define CLASS_SRC_MATRIX_SPARSE
 
+#include "kernels.hpp"
 #include "matrix.hpp"
 #include "matrix_sparse.hpp"
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <type_traits>
 
 /******************************************************************************
  * __Matrix__
@@ -25,47 +28,119 @@ Matrix_sparse<T>::Matrix_sparse(const int &a_noNonZero, const int &a_noRows, con
 }
 
 /******************************************************************************
- * __Matrix__
+ * __Matrix_sparse__
  * 
- * @details 	
+ * @details 	Converts any matrix, keeping only its nonzero entries.
+ * 
+ * @param[in] a_matrix 	The matrix to convert.
  ******************************************************************************/
 template<class T>
 Matrix_sparse<T>::Matrix_sparse(const Matrix<T> &a_matrix)
-: Matrix_sparse(a_matrix.get_noNonZero(), a_matrix.get_noRows(), a_matrix.get_noColumns())
 {
-	// Temporary vectors with matrix entries and column numbers.
-	std::vector<T> tempMatrixEntries(0);
-	std::vector<T> tempColumnNos(0);
-
-	for (int j=0; j<this->get_noRows(); ++j)
-	{
-		bool rowStartAssigned = false;
+	std::vector<int> xs;
+	std::vector<int> ys;
+	std::vector<T>   values;
 
-		for (int i=0; i<this->get_noColumns(); ++i)
+	for (int j=0; j<a_matrix.get_noRows(); ++j)
+		for (int i=0; i<a_matrix.get_noColumns(); ++i)
 		{
-			// Insert element if nonzero.
-			if (a_matrix(i, j) != 0)
-			{
-				tempMatrixEntries.push_back(a_matrix(i, j));
-				tempColumnNos    .push_back(i);
+			T value = a_matrix(i, j);
 
-				if (!rowStartAssigned)
-				{
-					this->rowStarts[j] = tempMatrixEntries.size();
-					rowStartAssigned = true;
-				}
+			if (value != 0)
+			{
+				xs    .push_back(i);
+				ys    .push_back(j);
+				values.push_back(value);
 			}
 		}
 
-		// If the row start still hasn't been assigned.
-		if (!rowStartAssigned)
-			rowStarts[j] = tempMatrixEntries.size();
+	Matrix_sparse<T> tempMatrix(a_matrix.get_noRows(), a_matrix.get_noColumns(), xs, ys);
+	tempMatrix.set_values(values);
+
+	this->matrixEntries  = tempMatrix.matrixEntries;
+	this->columnNos      = tempMatrix.columnNos;
+	this->rowStarts      = tempMatrix.rowStarts;
+	this->noColumns      = tempMatrix.noColumns;
+	this->tripletIndices = tempMatrix.tripletIndices;
+}
+
+/******************************************************************************
+ * __Matrix_sparse__
+ * 
+ * @details 	Creates a matrix with a given sparsity pattern, with all of the
+ * 				entries of the pattern set to zero.
+ * 
+ * @param[in] a_rowStarts 	Where each row starts in a_columnNos, with the
+ * 							 number of nonzeros appended.
+ * @param[in] a_columnNos 	The columns of the entries of each row, in
+ * 							 ascending order.
+ * @param[in] a_noColumns 	The number of columns.
+ ******************************************************************************/
+template<class T>
+Matrix_sparse<T>::Matrix_sparse(const std::vector<int> &a_rowStarts, const std::vector<int> &a_columnNos, const int &a_noColumns)
+{
+	this->rowStarts     = a_rowStarts;
+	this->columnNos     = a_columnNos;
+	this->matrixEntries .assign(a_columnNos.size(), 0);
+	this->noColumns     = a_noColumns;
+}
+
+/******************************************************************************
+ * __Matrix_sparse__
+ * 
+ * @details 	The symbolic phase of building from triplets: sorts the (x, y)
+ * 				positions by row then column, merges duplicates and compresses
+ * 				them into CSR in O(nnz log nnz). All entries start at zero and
+ * 				are filled in by set_values, which can be called again to
+ * 				refill the same pattern.
+ * 
+ * @param[in] a_noRows 		The number of rows.
+ * @param[in] a_noColumns 	The number of columns.
+ * @param[in] a_xs 			The column of each triplet.
+ * @param[in] a_ys 			The row of each triplet.
+ ******************************************************************************/
+template<class T>
+Matrix_sparse<T>::Matrix_sparse(const int &a_noRows, const int &a_noColumns, const std::vector<int> &a_xs, const std::vector<int> &a_ys)
+{
+	assert(a_xs.size() == a_ys.size());
+
+	int noTriplets = a_xs.size();
+
+	std::vector<int> order(noTriplets);
+	for (int k=0; k<noTriplets; ++k)
+		order[k] = k;
+
+	std::sort(order.begin(), order.end(), [&](const int &a_k1, const int &a_k2)
+	{
+		if (a_ys[a_k1] != a_ys[a_k2])
+			return a_ys[a_k1] < a_ys[a_k2];
+		return a_xs[a_k1] < a_xs[a_k2];
+	});
+
+	this->noColumns = a_noColumns;
+	this->rowStarts.assign(a_noRows+1, 0);
+	this->columnNos.clear();
+	this->tripletIndices.resize(noTriplets);
+
+	for (int k=0; k<noTriplets; ++k)
+	{
+		int x = a_xs[order[k]];
+		int y = a_ys[order[k]];
+
+		// A new entry unless it repeats the previous position.
+		if (k == 0 || x != a_xs[order[k-1]] || y != a_ys[order[k-1]])
+		{
+			this->columnNos.push_back(x);
+			++this->rowStarts[y+1];
+		}
+
+		this->tripletIndices[order[k]] = this->columnNos.size() - 1;
 	}
 
-	this->rowStarts[this->get_noRows()] = tempColumnNos.size();
+	for (int j=0; j<a_noRows; ++j)
+		this->rowStarts[j+1] += this->rowStarts[j];
 
-	this->matrixEntries = tempMatrixEntries;
-	this->columnNos = tempColumnNos;
+	this->matrixEntries.assign(this->columnNos.size(), 0);
 }
 
 /******************************************************************************
@@ -128,7 +203,7 @@ int Matrix_sparse<T>::get_index(const int &a_x, const int &a_y) const
 		++index;
 	}
 
-	if (a_x==this->columnNos[index] && thisRowStart!=nextRowStart)
+	if (index<nextRowStart)
 		return index;
 	else
 		return -1; // Code for a zero.
@@ -282,6 +357,65 @@ Matrix_sparse<T> Matrix_sparse<T>::operator/(const T &a_RHS)
 	return tempMatrix;
 }
 
+/******************************************************************************
+ * __multiply__
+ * 
+ * @details 	Calculates y = Ax, visiting only the stored entries.
+ * 
+ * @param[in] a_x 		The vector to multiply.
+ * @param[out] a_y 		The product, resized to the number of rows.
+ ******************************************************************************/
+template<class T>
+void Matrix_sparse<T>::multiply(const std::vector<T> &a_x, std::vector<T> &a_y) const
+{
+	int noRows = this->rowStarts.size() - 1;
+	a_y.resize(noRows);
+
+	// Vectorised kernels where available.
+	if constexpr (std::is_same<T, double>::value)
+	{
+		kernels::csrMultiply(noRows, this->rowStarts.data(), this->columnNos.data(), this->matrixEntries.data(), a_x.data(), a_y.data());
+		return;
+	}
+
+	const T*   entries = this->matrixEntries.data();
+	const int* columns = this->columnNos.data();
+	const int* starts  = this->rowStarts.data();
+
+	for (int j=0; j<noRows; ++j)
+	{
+		T sum = 0;
+
+		for (int index=starts[j]; index<starts[j+1]; ++index)
+			sum += entries[index] * a_x[columns[index]];
+
+		a_y[j] = sum;
+	}
+}
+
+/******************************************************************************
+ * __operator*__
+ * 
+ * @details 	Multiplies the matrix by a vector.
+ * 
+ * @param[in] a_RHS 	The vector.
+ * @return  			The product.
+ ******************************************************************************/
+template<class T>
+std::vector<T> Matrix_sparse<T>::operator*(const std::vector<T> &a_RHS) const
+{
+	if (this->get_noColumns() != a_RHS.size())
+	{
+		std::cerr << "Error: Matrix-vector dimensions do not match." << std::endl;
+		return a_RHS;
+	}
+
+	std::vector<T> tempVector;
+	this->multiply(a_RHS, tempVector);
+
+	return tempVector;
+}
+
 /******************************************************************************
  * __get_noNonZero__
  * 
@@ -316,103 +450,244 @@ int Matrix_sparse<T>::get_noColumns() const
 }
 
 /******************************************************************************
- * __set__
+ * __get_rowStarts__
  * 
- * @details 	
+ * @details 	The raw CSR arrays, for kernels that walk the storage directly.
  ******************************************************************************/
 template<class T>
-void Matrix_sparse<T>::set(const int &a_x, const int &a_y, const T &a_value) // There's a bug somewhere in here...
+const std::vector<int>& Matrix_sparse<T>::get_rowStarts() const
 {
-	// If the element already exists, then we just overwrite it.
-	if (this->get_index(a_x, a_y) != -1)
-	{
-		this->matrixEntries[this->get_index(a_x, a_y)] = a_value;
-	}
-	//this feels bad...
-	else if ((this->matrixEntries.size() == 1) and (this->matrixEntries[0] == 0))
+	return this->rowStarts;
+}
+
+template<class T>
+const std::vector<int>& Matrix_sparse<T>::get_columnNos() const
+{
+	return this->columnNos;
+}
+
+template<class T>
+const std::vector<T>& Matrix_sparse<T>::get_matrixEntries() const
+{
+	return this->matrixEntries;
+}
+
+/******************************************************************************
+ * __get_product__
+ * 
+ * @details 	Multiplies two sparse matrices row by row (Gustavson), each row
+ * 				of the product summing the rows of the right-hand side picked
+ * 				out by a row of this one. Costs O(rows + products).
+ * 
+ * @param[in] a_RHS 	The right-hand side.
+ * @return  			The product, with the columns of each row in order.
+ ******************************************************************************/
+template<class T>
+Matrix_sparse<T> Matrix_sparse<T>::get_product(const Matrix_sparse<T> &a_RHS) const
+{
+	assert(this->noColumns == a_RHS.get_noRows());
+
+	int noRows = this->get_noRows();
+
+	Matrix_sparse<T> product(std::vector<int>(1, 0), std::vector<int>(), a_RHS.noColumns);
+	product.rowStarts.reserve(noRows+1);
+
+	// Where each column is in the product; positions before the start of
+	//  the current row are left over from earlier rows.
+	std::vector<int> positions(a_RHS.noColumns, -1);
+	std::vector<int> order;
+	std::vector<int> sortedColumnNos;
+	std::vector<T>   sortedEntries;
+
+	for (int j=0; j<noRows; ++j)
 	{
-		this->matrixEntries[0] = a_value;
-		this->columnNos[0] = a_x;
+		int rowStart = product.columnNos.size();
 
-		for (int i=a_y+1; i<this->rowStarts.size(); ++i)
-			++this->rowStarts[i];
+		for (int index=this->rowStarts[j]; index<this->rowStarts[j+1]; ++index)
+		{
+			int k   = this->columnNos[index];
+			T value = this->matrixEntries[index];
+
+			for (int indexRHS=a_RHS.rowStarts[k]; indexRHS<a_RHS.rowStarts[k+1]; ++indexRHS)
+			{
+				int i = a_RHS.columnNos[indexRHS];
+
+				if (positions[i] < rowStart)
+				{
+					positions[i] = product.columnNos.size();
+					product.columnNos    .push_back(i);
+					product.matrixEntries.push_back(value*a_RHS.matrixEntries[indexRHS]);
+				}
+				else
+					product.matrixEntries[positions[i]] += value*a_RHS.matrixEntries[indexRHS];
+			}
+		}
+
+		// Puts the row's columns in order.
+		int rowEnd = product.columnNos.size();
+		order.resize(rowEnd - rowStart);
+		for (int k=0; k<order.size(); ++k)
+			order[k] = rowStart + k;
+		std::sort(order.begin(), order.end(), [&](const int &a_k1, const int &a_k2)
+		{
+			return product.columnNos[a_k1] < product.columnNos[a_k2];
+		});
+
+		sortedColumnNos.resize(order.size());
+		sortedEntries  .resize(order.size());
+		for (int k=0; k<order.size(); ++k)
+		{
+			sortedColumnNos[k] = product.columnNos    [order[k]];
+			sortedEntries[k]   = product.matrixEntries[order[k]];
+		}
+		std::copy(sortedColumnNos.begin(), sortedColumnNos.end(), product.columnNos    .begin() + rowStart);
+		std::copy(sortedEntries  .begin(), sortedEntries  .end(), product.matrixEntries.begin() + rowStart);
+
+		product.rowStarts.push_back(rowEnd);
 	}
-	else
-	{
-		int thisRowStart = this->rowStarts[a_y];
-		int nextRowStart = this->rowStarts[a_y+1];
 
-		int index;
-		bool foundIndex = false;
+	return product;
+}
 
-		for (index=thisRowStart; index<nextRowStart && !foundIndex; ++index)
-			if (columnNos[index] < a_x)
-				foundIndex = true;
+/******************************************************************************
+ * __get_transpose__
+ * 
+ * @details 	Transposes by counting the entries of each column, then
+ * 				scattering the rows in order so that each row of the
+ * 				transpose is in column order.
+ ******************************************************************************/
+template<class T>
+Matrix_sparse<T> Matrix_sparse<T>::get_transpose() const
+{
+	int noRows = this->get_noRows();
 
-		         std::vector<int>::iterator colIt = this->columnNos    .begin() + index;
-		typename std::vector<T>  ::iterator matIt = this->matrixEntries.begin() + index;
+	std::vector<int> rowStarts(this->noColumns+1, 0);
+	for (int index=0; index<this->columnNos.size(); ++index)
+		++rowStarts[this->columnNos[index]+1];
+	for (int i=0; i<this->noColumns; ++i)
+		rowStarts[i+1] += rowStarts[i];
 
+	Matrix_sparse<T> transpose(rowStarts, std::vector<int>(this->columnNos.size()), noRows);
 
+	std::vector<int> next(rowStarts.begin(), rowStarts.end()-1);
+	for (int j=0; j<noRows; ++j)
+		for (int index=this->rowStarts[j]; index<this->rowStarts[j+1]; ++index)
+		{
+			int position = next[this->columnNos[index]]++;
 
-		// Inserts value at correct location.
-		this->columnNos.insert(colIt, a_x);
-		this->matrixEntries.insert(matIt, a_value);
+			transpose.columnNos    [position] = j;
+			transpose.matrixEntries[position] = this->matrixEntries[index];
+		}
 
-		// Update all following row starts.
-		for (int i=a_y+1; i<this->rowStarts.size(); ++i)
-			++this->rowStarts[i];
+	return transpose;
+}
 
-		// DOESN'T QUITE WORK
-		// PRINT OUT ALL THREE VECTORS TO DEBUG
-	
+/******************************************************************************
+ * __get_permuted__
+ * 
+ * @details 	Renumbers the rows and columns alike, P A P^T, by scattering
+ * 				each row to its new position and then sorting the columns of
+ * 				each row, which are few, by insertion.
+ * 
+ * @param[in] a_numbering 	The new number of each row and column.
+ ******************************************************************************/
+template<class T>
+Matrix_sparse<T> Matrix_sparse<T>::get_permuted(const std::vector<int> &a_numbering) const
+{
+	int noRows = this->get_noRows();
+	assert(noRows == this->noColumns && a_numbering.size() == noRows);
 
+	std::vector<int> rowStarts(noRows+1, 0);
+	for (int j=0; j<noRows; ++j)
+		rowStarts[a_numbering[j]+1] = this->rowStarts[j+1] - this->rowStarts[j];
+	for (int i=0; i<noRows; ++i)
+		rowStarts[i+1] += rowStarts[i];
 
+	Matrix_sparse<T> permuted(rowStarts, std::vector<int>(this->columnNos.size()), noRows);
 
-		// this->matrixEntries
-		// this->columnNos
-		// this->rowStarts
-		 
-		/*int rowEntryIndex     = this->rowStarts[a_y];
-		int nextRowEntryIndex = this->rowStarts[a_y+1];
-		bool finished = false;
+	for (int j=0; j<noRows; ++j)
+	{
+		int rowStart = rowStarts[a_numbering[j]];
+		int noEntries = 0;
 
-		for (int i=rowEntryIndex; i<nextRowEntryIndex && ~finished; ++i)
+		for (int index=this->rowStarts[j]; index<this->rowStarts[j+1]; ++index, ++noEntries)
 		{
-			int columnNo = this->columnNos[i];
-			std::cout << "cn" << columnNo << std::endl;
+			int column = a_numbering[this->columnNos[index]];
+			T   entry  = this->matrixEntries[index];
 
-			// We've just gone past the column we want.
-			if (columnNo > a_x)
+			int position = rowStart + noEntries;
+			for (; position > rowStart && permuted.columnNos[position-1] > column; --position)
 			{
-				typename std::vector<T>  ::iterator itMatrixEntries = this->matrixEntries.begin() + i-1;
-				         std::vector<int>::iterator itColumnNos     = this->columnNos    .begin() + i-1;
+				permuted.columnNos    [position] = permuted.columnNos    [position-1];
+				permuted.matrixEntries[position] = permuted.matrixEntries[position-1];
+			}
+			permuted.columnNos    [position] = column;
+			permuted.matrixEntries[position] = entry;
+		}
+	}
 
-				this->matrixEntries.insert(itMatrixEntries, a_value); // Is insert the best way of doing what I want? This will increase the lengths...
-				this->columnNos    .insert(itColumnNos    , a_x);
+	return permuted;
+}
 
-				for (int j=a_y+1; j<=this->rowStarts.size(); ++j)
-					++this->rowStarts[j];
+/******************************************************************************
+ * __set__
+ * 
+ * @details 	
+ ******************************************************************************/
+template<class T>
+void Matrix_sparse<T>::set(const int &a_x, const int &a_y, const T &a_value)
+{
+	int index = this->get_index(a_x, a_y);
 
-				finished = true;
-			}
-		}*/
+	// If the element already exists, then we just overwrite it.
+	if (index != -1)
+	{
+		this->matrixEntries[index] = a_value;
+		return;
 	}
 
-	std::cout << "ROW STARTS" << std::endl;
-	for (int i=0; i<this->rowStarts.size(); ++i)
-		std::cout << rowStarts[i] << " ";
-	std::cout << std::endl << std::endl;
+	// Zeros outside the sparsity pattern are already implied.
+	if (a_value == 0)
+		return;
+
+	// Otherwise inserts it, keeping the row's columns in order.
+	int thisRowStart = this->rowStarts[a_y];
+	int nextRowStart = this->rowStarts[a_y+1];
+
+	index = thisRowStart;
+	while (index<nextRowStart && this->columnNos[index]<a_x)
+		++index;
+
+	this->columnNos    .insert(this->columnNos    .begin() + index, a_x);
+	this->matrixEntries.insert(this->matrixEntries.begin() + index, a_value);
 
-	std::cout << "COLUMN NOS" << std::endl;
-	for (int i=0; i<this->columnNos.size(); ++i)
-		std::cout << columnNos[i] << " ";
-	std::cout << std::endl << std::endl;
+	// Update all following row starts.
+	for (int i=a_y+1; i<this->rowStarts.size(); ++i)
+		++this->rowStarts[i];
 
-	std::cout << "MATRIX ENTRIES" << std::endl;
-	for (int i=0; i<this->matrixEntries.size(); ++i)
-		std::cout << matrixEntries[i] << " ";
-	std::cout << std::endl << std::endl;
+	// The pattern has changed, so the triplets no longer map onto it.
+	this->tripletIndices.clear();
 }
 
+/******************************************************************************
+ * __set_values__
+ * 
+ * @details 	The numeric phase of building from triplets: replaces every
+ * 				entry with the sum of the values of the triplets at its
+ * 				position.
+ * 
+ * @param[in] a_values 	The value of each triplet, in the order they were
+ * 						 given to the symbolic phase.
+ ******************************************************************************/
+template<class T>
+void Matrix_sparse<T>::set_values(const std::vector<T> &a_values)
+{
+	assert(a_values.size() == this->tripletIndices.size());
+
+	std::fill(this->matrixEntries.begin(), this->matrixEntries.end(), 0);
+
+	for (int k=0; k<a_values.size(); ++k)
+		this->matrixEntries[this->tripletIndices[k]] += a_values[k];
+}
 
 #endif
\ No newline at end of file
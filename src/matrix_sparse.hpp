@@ -24,6 +24,9 @@ class Matrix_sparse: public Matrix<T>
 		std::vector<int> rowStarts;
 		int              noColumns;
 
+		// Where each triplet of the symbolic phase is summed into.
+		std::vector<int> tripletIndices;
+
 		// Resizing.
 		void resize(const int &a_noNonZeros);
 		void resize(const int &a_noNonZeros, const int &a_noRows);
@@ -39,7 +42,8 @@ class Matrix_sparse: public Matrix<T>
 		// Constructors.
 		Matrix_sparse(const int &a_noNonZero, const int &a_noRows, const int &a_noColumns);
 		Matrix_sparse(const Matrix<T> &a_matrix);
-		//add constructor with columnNos and rowStarts already added?
+		Matrix_sparse(const std::vector<int> &a_rowStarts, const std::vector<int> &a_columnNos, const int &a_noColumns);
+		Matrix_sparse(const int &a_noRows, const int &a_noColumns, const std::vector<int> &a_xs, const std::vector<int> &a_ys);
 
 		// Matrix-Matrix operations.
 		Matrix_sparse<T> operator+(const Matrix<T> &a_RHS);
@@ -50,13 +54,24 @@ class Matrix_sparse: public Matrix<T>
 		Matrix_sparse<T> operator*(const T &a_RHS);
 		Matrix_sparse<T> operator/(const T &a_RHS);
 
+		// Matrix-vector operations.
+		void           multiply(const std::vector<T> &a_x, std::vector<T> &a_y) const final;
+		std::vector<T> operator*(const std::vector<T> &a_RHS) const;
+
 		// Getters.
 		int get_noNonZero() const;
 		int get_noRows() const;
 		int get_noColumns() const;
+		const std::vector<int>& get_rowStarts() const;
+		const std::vector<int>& get_columnNos() const;
+		const std::vector<T>&   get_matrixEntries() const;
+		Matrix_sparse<T>        get_product(const Matrix_sparse<T> &a_RHS) const;
+		Matrix_sparse<T>        get_transpose() const;
+		Matrix_sparse<T>        get_permuted(const std::vector<int> &a_numbering) const;
 
 		// Setting.
 		void set(const int &a_x, const int &a_y, const T &a_value);
+		void set_values(const std::vector<T> &a_values);
 };
 
 #include "matrix_sparse.cpp"
@@ -39,6 +39,20 @@ Mesh::Mesh(Elements* const &a_elements)
 	this->ownsElements = false;
 }
 
+/******************************************************************************
+ * __Mesh__
+ * 
+ * @details 	Copy constructor. The copy shares the elements of the original
+ * 				mesh and does not own them.
+ * 
+ * @param[in] a_mesh 		The mesh to copy.
+ ******************************************************************************/
+Mesh::Mesh(const Mesh &a_mesh)
+: Mesh::Mesh(a_mesh.elements)
+{
+	//
+}
+
 /******************************************************************************
  * __~Mesh__
  * 
@@ -21,6 +21,7 @@ class Mesh
 		Elements* elements;
 		Mesh(const int &a_noElements);
 		Mesh(Elements* const &a_elements);
+		Mesh(const Mesh &a_mesh);
 		~Mesh();
 
 		int get_dimProblem() const;
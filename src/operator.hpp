@@ -0,0 +1,27 @@
+/******************************************************************************
+ * @details Declarations for [Operator].
+ * 
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/15
+ ******************************************************************************/
+#ifndef CLASS_OPERATOR
+#define CLASS_OPERATOR
+
+#include <vector>
+
+// A linear map known only through its action y = Ax, e.g. for solvers that
+//  never need the entries of A.
+class Operator
+{
+	public:
+		virtual ~Operator() {}
+
+		// Getters.
+		virtual int get_noRows() const = 0;
+		virtual int get_noColumns() const = 0;
+
+		// Matrix-vector operations.
+		virtual void multiply(const std::vector<double> &a_x, std::vector<double> &a_y) const = 0;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,264 @@
+/******************************************************************************
+ * @details This is a file containing definitions of [Operator_matrixFree].
+ * 
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/15
+ ******************************************************************************/
+#include "basis.hpp"
+#include "element.hpp"
+#include "operator_matrixFree.hpp"
+#include "quadrature.hpp"
+#include <algorithm>
+#include <vector>
+
+/******************************************************************************
+ * __Operator_matrixFree__
+ * 
+ * @details 	Gathers the DoFs and tabulated bases of every element. The
+ * 				quadrature policies of the elements must already be set; the
+ * 				coefficients are given by set_coefficients.
+ * 
+ * @param[in] a_elements 		The mesh.
+ * @param[in] a_massLumping 	Whether to keep only the diagonal of the mass
+ * 								 term.
+ ******************************************************************************/
+Operator_matrixFree::Operator_matrixFree(Elements* const &a_elements, const bool &a_massLumping)
+{
+	this->noDoFs      = a_elements->get_DoF();
+	this->noElements  = a_elements->get_noElements();
+	this->massLumping = a_massLumping;
+
+	this->DoFStarts      .resize(this->noElements+1, 0);
+	this->stiffnessStarts.resize(this->noElements+1, 0);
+	this->massStarts     .resize(this->noElements+1, 0);
+	this->stiffnessBases .resize(this->noElements);
+	this->massBases      .resize(this->noElements);
+
+	for (int i=0; i<this->noElements; ++i)
+	{
+		Element* currentElement = (*a_elements)[i];
+
+		std::vector<int> elementDoFs = a_elements->get_elementDoFs(i);
+		this->DoFs.insert(this->DoFs.end(), elementDoFs.begin(), elementDoFs.end());
+		this->DoFStarts[i+1] = this->DoFs.size();
+
+		this->stiffnessBases[i] = &currentElement->get_elementBasis(quadrature::Stiffness);
+		this->massBases[i]      = &currentElement->get_elementBasis(quadrature::Mass);
+
+		this->stiffnessStarts[i+1] = this->stiffnessStarts[i] + this->stiffnessBases[i]->noPoints;
+		this->massStarts[i+1]      = this->massStarts[i]      + this->massBases[i]->noPoints;
+	}
+
+	this->stiffnessWeights.resize(this->stiffnessStarts.back(), 0);
+	this->massWeights     .resize(this->massStarts.back(), 0);
+	if (this->massLumping)
+		this->lumpedMasses.resize(this->DoFs.size(), 0);
+	this->DoFMasks.assign(this->DoFs.size(), 1);
+
+	int noPoints = 0;
+	for (int i=0; i<this->noElements; ++i)
+		noPoints = std::max(noPoints, std::max(this->stiffnessBases[i]->noPoints, this->massBases[i]->noPoints));
+	this->pointValues.resize(noPoints);
+}
+
+int Operator_matrixFree::get_noRows() const
+{
+	return this->noDoFs;
+}
+
+int Operator_matrixFree::get_noColumns() const
+{
+	return this->noDoFs;
+}
+
+/******************************************************************************
+ * __get_diagonal__
+ * 
+ * @details 	The diagonal of the matrix, e.g. for a Jacobi preconditioner.
+ ******************************************************************************/
+std::vector<double> Operator_matrixFree::get_diagonal() const
+{
+	std::vector<double> diagonal(this->noDoFs, 0);
+
+	for (int i=0; i<this->noElements; ++i)
+	{
+		const int* DoFs = &this->DoFs[this->DoFStarts[i]];
+		int noDoFs = this->DoFStarts[i+1] - this->DoFStarts[i];
+
+		const double* stiffnessWeights = &this->stiffnessWeights[this->stiffnessStarts[i]];
+		const double* massWeights      = &this->massWeights[this->massStarts[i]];
+
+		for (int b=0; b<noDoFs; ++b)
+		{
+			const double* basis_ = this->stiffnessBases[i]->get_row(b, 1);
+			for (int k=0; k<this->stiffnessBases[i]->noPoints; ++k)
+				diagonal[DoFs[b]] += basis_[k]*basis_[k]*stiffnessWeights[k];
+
+			if (this->massLumping)
+			{
+				diagonal[DoFs[b]] += this->lumpedMasses[this->DoFStarts[i]+b];
+				continue;
+			}
+
+			const double* basis = this->massBases[i]->get_row(b, 0);
+			for (int k=0; k<this->massBases[i]->noPoints; ++k)
+				diagonal[DoFs[b]] += basis[k]*basis[k]*massWeights[k];
+		}
+	}
+
+	for (int i=0; i<this->boundaryDoFs.size(); ++i)
+		diagonal[this->boundaryDoFs[i]] += this->boundaryCoefficients[i];
+
+	for (int i=0; i<this->dirichletDoFs.size(); ++i)
+		diagonal[this->dirichletDoFs[i]] = 1;
+
+	return diagonal;
+}
+
+/******************************************************************************
+ * __set_coefficients__
+ * 
+ * @details 	Evaluates the coefficients at every quadrature point. This is
+ * 				all that changes between Newton iterations.
+ * 
+ * @param[in] a_elements 				The mesh the operator was built on.
+ * @param[in] a_stiffnessCoefficient 	A_1 at the kth point of the Stiffness
+ * 										 rule of an element.
+ * @param[in] a_massCoefficient 		A_0 at the kth point of the Mass rule
+ * 										 of an element.
+ ******************************************************************************/
+void Operator_matrixFree::set_coefficients(Elements* const &a_elements, const f_pointCoefficient &a_stiffnessCoefficient, const f_pointCoefficient &a_massCoefficient)
+{
+	for (int i=0; i<this->noElements; ++i)
+	{
+		Element* currentElement = (*a_elements)[i];
+		double J = currentElement->get_Jacobian();
+
+		const quadrature::Rule &stiffnessRule = currentElement->get_elementQuadrature(quadrature::Stiffness);
+		double* stiffnessWeights = &this->stiffnessWeights[this->stiffnessStarts[i]];
+		for (int k=0; k<stiffnessRule.noPoints; ++k)
+			stiffnessWeights[k] = a_stiffnessCoefficient(currentElement, k)*stiffnessRule.weights[k]/J;
+
+		const quadrature::Rule &massRule = currentElement->get_elementQuadrature(quadrature::Mass);
+		double* massWeights = &this->massWeights[this->massStarts[i]];
+		for (int k=0; k<massRule.noPoints; ++k)
+			massWeights[k] = a_massCoefficient(currentElement, k)*massRule.weights[k]*J;
+
+		if (!this->massLumping)
+			continue;
+
+		for (int b=0; b<this->DoFStarts[i+1]-this->DoFStarts[i]; ++b)
+		{
+			const double* basis = this->massBases[i]->get_row(b, 0);
+
+			double mass = 0;
+			for (int k=0; k<massRule.noPoints; ++k)
+				mass += basis[k]*basis[k]*massWeights[k];
+
+			this->lumpedMasses[this->DoFStarts[i]+b] = mass;
+		}
+	}
+}
+
+/******************************************************************************
+ * __set_dirichletDoFs__
+ * 
+ * @details 	Sets the DoFs whose rows and columns are replaced by those of
+ * 				the identity.
+ ******************************************************************************/
+void Operator_matrixFree::set_dirichletDoFs(const std::vector<int> &a_dirichletDoFs)
+{
+	this->dirichletDoFs = a_dirichletDoFs;
+
+	std::vector<bool> isDirichlet(this->noDoFs, false);
+	for (int i=0; i<this->dirichletDoFs.size(); ++i)
+		isDirichlet[this->dirichletDoFs[i]] = true;
+
+	for (int index=0; index<this->DoFs.size(); ++index)
+		this->DoFMasks[index] = isDirichlet[this->DoFs[index]]?0:1;
+}
+
+/******************************************************************************
+ * __set_boundaryCoefficients__
+ * 
+ * @details 	Sets coefficients added to the diagonal at the given DoFs, as
+ * 				from the terms of Robin conditions.
+ ******************************************************************************/
+void Operator_matrixFree::set_boundaryCoefficients(const std::vector<int> &a_boundaryDoFs, const std::vector<double> &a_boundaryCoefficients)
+{
+	this->boundaryDoFs         = a_boundaryDoFs;
+	this->boundaryCoefficients = a_boundaryCoefficients;
+}
+
+/******************************************************************************
+ * __multiply__
+ * 
+ * @details 	Calculates y = Ax. On each element, x and x' are interpolated
+ * 				to the quadrature points, scaled by the weighted coefficients
+ * 				and tested against every basis function, which is O(p) work
+ * 				per DoF where an assembled matrix would hold O(p) entries
+ * 				per row and a dense element matrix O(p^2) per element.
+ * 
+ * @param[in] a_x 		The vector to multiply.
+ * @param[out] a_y 		The product.
+ ******************************************************************************/
+void Operator_matrixFree::multiply(const std::vector<double> &a_x, std::vector<double> &a_y) const
+{
+	a_y.assign(this->noDoFs, 0);
+
+	double* pointValues = this->pointValues.data();
+
+	for (int i=0; i<this->noElements; ++i)
+	{
+		const int*    DoFs  = &this->DoFs[this->DoFStarts[i]];
+		const double* masks = &this->DoFMasks[this->DoFStarts[i]];
+		int noDoFs = this->DoFStarts[i+1] - this->DoFStarts[i];
+
+		// Applies sum_k w_k phi_b^{(d)}(x_k) sum_a x_a phi_a^{(d)}(x_k).
+		auto apply = [&](const basis::Tabulation* const &a_basis, const double* const &a_weights, const int &a_derivative)
+		{
+			int noPoints = a_basis->noPoints;
+			std::fill(pointValues, pointValues + noPoints, 0);
+
+			// Dirichlet DoFs don't couple to the rest.
+			for (int a=0; a<noDoFs; ++a)
+			{
+				double x_a = masks[a]*a_x[DoFs[a]];
+				const double* basis = a_basis->get_row(a, a_derivative);
+
+				for (int k=0; k<noPoints; ++k)
+					pointValues[k] += x_a*basis[k];
+			}
+
+			for (int k=0; k<noPoints; ++k)
+				pointValues[k] *= a_weights[k];
+
+			for (int b=0; b<noDoFs; ++b)
+			{
+				const double* basis = a_basis->get_row(b, a_derivative);
+
+				double sum = 0;
+				for (int k=0; k<noPoints; ++k)
+					sum += basis[k]*pointValues[k];
+
+				a_y[DoFs[b]] += sum;
+			}
+		};
+
+		apply(this->stiffnessBases[i], &this->stiffnessWeights[this->stiffnessStarts[i]], 1);
+
+		// Lumped masses and boundary terms only touch their own rows, and
+		//  those of Dirichlet DoFs are overwritten below.
+		if (this->massLumping)
+			for (int b=0; b<noDoFs; ++b)
+				a_y[DoFs[b]] += this->lumpedMasses[this->DoFStarts[i]+b]*a_x[DoFs[b]];
+		else
+			apply(this->massBases[i], &this->massWeights[this->massStarts[i]], 0);
+	}
+
+	for (int i=0; i<this->boundaryDoFs.size(); ++i)
+		a_y[this->boundaryDoFs[i]] += this->boundaryCoefficients[i]*a_x[this->boundaryDoFs[i]];
+
+	for (int i=0; i<this->dirichletDoFs.size(); ++i)
+		a_y[this->dirichletDoFs[i]] = a_x[this->dirichletDoFs[i]];
+}
\ No newline at end of file
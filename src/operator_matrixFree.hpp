@@ -0,0 +1,79 @@
+/******************************************************************************
+ * @details Declarations for [Operator_matrixFree].
+ * 
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/15
+ ******************************************************************************/
+#ifndef CLASS_OPERATOR_MATRIXFREE
+#define CLASS_OPERATOR_MATRIXFREE
+
+#include "basis.hpp"
+#include "element.hpp"
+#include "operator.hpp"
+#include <functional>
+#include <vector>
+
+// A coefficient at the kth quadrature point of an element.
+typedef std::function<double(Element*, const int&)> f_pointCoefficient;
+
+// The action of the global matrix of
+//  a(u, v) = int A_1 u' v' + A_0 u v dx,
+//  applied element by element from the tabulated basis without forming any
+//  matrix. The stiffness and mass terms use each element's Stiffness and
+//  Mass quadrature rules, and Dirichlet DoFs act as rows and columns of the
+//  identity. Boundary terms such as those of Robin conditions add to single
+//  diagonal entries.
+class Operator_matrixFree: public Operator
+{
+	private:
+		int noDoFs;
+		int noElements;
+
+		// Element i's DoFs are DoFs[DoFStarts[i]] to DoFs[DoFStarts[i+1]-1].
+		std::vector<int> DoFStarts;
+		std::vector<int> DoFs;
+
+		// Basis values at each element's quadrature points.
+		std::vector<const basis::Tabulation*> stiffnessBases;
+		std::vector<const basis::Tabulation*> massBases;
+
+		// Coefficients at each element's quadrature points, premultiplied by
+		//  the weights and the powers of the Jacobian.
+		std::vector<int>    stiffnessStarts;
+		std::vector<int>    massStarts;
+		std::vector<double> stiffnessWeights;
+		std::vector<double> massWeights;
+
+		// A lumped mass matrix keeps only its diagonal, stored like DoFs.
+		bool massLumping;
+		std::vector<double> lumpedMasses;
+
+		// Dirichlet columns are masked out of each element, stored like DoFs,
+		//  so that multiply need not copy x to zero them.
+		std::vector<int> dirichletDoFs;
+		std::vector<double> DoFMasks;
+		std::vector<int> boundaryDoFs;
+		std::vector<double> boundaryCoefficients;
+
+		// Scratch space for multiply, sized for the most quadrature points.
+		mutable std::vector<double> pointValues;
+
+	public:
+		// Constructors.
+		Operator_matrixFree(Elements* const &a_elements, const bool &a_massLumping);
+
+		// Getters.
+		int get_noRows() const;
+		int get_noColumns() const;
+		std::vector<double> get_diagonal() const;
+
+		// Setters.
+		void set_coefficients(Elements* const &a_elements, const f_pointCoefficient &a_stiffnessCoefficient, const f_pointCoefficient &a_massCoefficient);
+		void set_dirichletDoFs(const std::vector<int> &a_dirichletDoFs);
+		void set_boundaryCoefficients(const std::vector<int> &a_boundaryDoFs, const std::vector<double> &a_boundaryCoefficients);
+
+		// Matrix-vector operations.
+		void multiply(const std::vector<double> &a_x, std::vector<double> &a_y) const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,22 @@
+/******************************************************************************
+ * @details Declarations for [Preconditioner].
+ * 
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/16
+ ******************************************************************************/
+#ifndef CLASS_PRECONDITIONER
+#define CLASS_PRECONDITIONER
+
+#include <vector>
+
+// An approximation M of a matrix A, applied as z = M^{-1} r inside
+//  preconditioned CG. M must be symmetric positive definite.
+class Preconditioner
+{
+	public:
+		virtual ~Preconditioner() {}
+
+		virtual void apply(const std::vector<double> &a_r, std::vector<double> &a_z) const = 0;
+};
+
+#endif
\ No newline at end of file
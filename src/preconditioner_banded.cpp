@@ -0,0 +1,29 @@
+/******************************************************************************
+ * @details This is a file containing definitions of [Preconditioner_banded].
+ * 
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/24
+ ******************************************************************************/
+#include "matrix_banded.hpp"
+#include "matrix_sparse.hpp"
+#include "preconditioner_banded.hpp"
+#include <vector>
+
+/******************************************************************************
+ * __Preconditioner_banded__
+ * 
+ * @details 	Rounds the matrix to float and factorises it.
+ * 
+ * @param[in] a_matrix 	The symmetric positive definite matrix.
+ ******************************************************************************/
+Preconditioner_banded::Preconditioner_banded(const Matrix_sparse<double> &a_matrix): factors(a_matrix)
+{
+	this->factors.factorise();
+}
+
+void Preconditioner_banded::apply(const std::vector<double> &a_r, std::vector<double> &a_z) const
+{
+	this->r.assign(a_r.begin(), a_r.end());
+	this->factors.solve(this->r, this->z);
+	a_z.assign(this->z.begin(), this->z.end());
+}
\ No newline at end of file
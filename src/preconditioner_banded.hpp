@@ -0,0 +1,34 @@
+/******************************************************************************
+ * @details Declarations for [Preconditioner_banded].
+ * 
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/24
+ ******************************************************************************/
+#ifndef CLASS_PRECONDITIONER_BANDED
+#define CLASS_PRECONDITIONER_BANDED
+
+#include "matrix_banded.hpp"
+#include "matrix_sparse.hpp"
+#include "preconditioner.hpp"
+#include <vector>
+
+// M = U^T D U, the banded LDL^T factorisation of A computed and applied in
+//  single precision. This is A up to the rounding of float, so it solves to
+//  about seven digits. The factors overwrite the rounded band, so they take
+//  half the memory of double factors and each solve reads half as much.
+class Preconditioner_banded: public Preconditioner
+{
+	private:
+		Matrix_banded<float> factors;
+
+		// Scratch space for apply, so that it does not allocate.
+		mutable std::vector<float> r;
+		mutable std::vector<float> z;
+
+	public:
+		Preconditioner_banded(const Matrix_sparse<double> &a_matrix);
+
+		void apply(const std::vector<double> &a_r, std::vector<double> &a_z) const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,175 @@
+/******************************************************************************
+ * @details This is a file containing definitions of
+ * 				[Preconditioner_blockJacobi].
+ * 
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/16
+ ******************************************************************************/
+#include "matrix_sparse.hpp"
+#include "preconditioner_blockJacobi.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+/******************************************************************************
+ * __Preconditioner_blockJacobi__
+ * 
+ * @details 	Extracts and factorises every diagonal block. Blocks of a
+ * 				symmetric positive definite matrix are too, but should round-
+ * 				off give a pivot that is not positive, the block is
+ * 				factorised again with its diagonal scaled by 1 + shift, the
+ * 				shift doubling from 1e-3 until it succeeds. The largest
+ * 				shift used is kept, for get_shift.
+ * 
+ * @param[in] a_matrix 		The matrix.
+ * @param[in] a_blockStarts Where each block starts in a_blockDoFs, with the
+ * 							 number of DoFs appended.
+ * @param[in] a_blockDoFs 	The DoFs of each block; every DoF must be in at
+ * 							 least one block.
+ ******************************************************************************/
+Preconditioner_blockJacobi::Preconditioner_blockJacobi(const Matrix_sparse<double> &a_matrix, const std::vector<int> &a_blockStarts, const std::vector<int> &a_blockDoFs)
+{
+	this->blockStarts = a_blockStarts;
+	this->blockDoFs   = a_blockDoFs;
+
+	int noBlocks = this->blockStarts.size() - 1;
+	this->factorStarts.resize(noBlocks+1, 0);
+	int largestBlock = 0;
+	for (int i=0; i<noBlocks; ++i)
+	{
+		int N = this->blockStarts[i+1] - this->blockStarts[i];
+		this->factorStarts[i+1] = this->factorStarts[i] + N*N;
+		largestBlock = std::max(largestBlock, N);
+	}
+	this->factors.resize(this->factorStarts.back(), 0);
+	this->y.reserve(largestBlock);
+
+	const std::vector<int>    &rowStarts = a_matrix.get_rowStarts();
+	const std::vector<int>    &columnNos = a_matrix.get_columnNos();
+	const std::vector<double> &entries   = a_matrix.get_matrixEntries();
+
+	// Position of each DoF within its block.
+	std::vector<int> localIndices(a_matrix.get_noRows(), -1);
+
+	for (int i=0; i<noBlocks; ++i)
+	{
+		const int* DoFs = &this->blockDoFs[this->blockStarts[i]];
+		int N = this->blockStarts[i+1] - this->blockStarts[i];
+		double* L = &this->factors[this->factorStarts[i]];
+
+		for (int a=0; a<N; ++a)
+			localIndices[DoFs[a]] = a;
+
+		for (int a=0; a<N; ++a)
+			for (int index=rowStarts[DoFs[a]]; index<rowStarts[DoFs[a]+1]; ++index)
+			{
+				int b = localIndices[columnNos[index]];
+				if (b != -1)
+					L[a*N + b] = entries[index];
+			}
+
+		for (int a=0; a<N; ++a)
+			localIndices[DoFs[a]] = -1;
+
+		// As in Preconditioner_incompleteCholesky, a positive diagonal
+		//  ensures a large enough shift succeeds.
+		for (int a=0; a<N; ++a)
+			assert(L[a*N + a] > 0);
+
+		std::vector<double> block(L, L + N*N);
+		double shift = 0;
+		while (!factorise(N, L))
+		{
+			shift = (shift == 0)?1e-3:2*shift;
+
+			std::copy(block.begin(), block.end(), L);
+			for (int a=0; a<N; ++a)
+				L[a*N + a] *= 1 + shift;
+		}
+		this->shift = std::max(this->shift, shift);
+	}
+}
+
+/******************************************************************************
+ * __factorise__
+ * 
+ * @details 	Dense Cholesky in place; the lower triangle becomes L.
+ * 
+ * @param[in] a_N 		The size of the block.
+ * @param[in,out] a_L 	The block, row by row.
+ * @return 				Whether every pivot was positive.
+ ******************************************************************************/
+bool Preconditioner_blockJacobi::factorise(const int &a_N, double a_L[])
+{
+	for (int a=0; a<a_N; ++a)
+	{
+		for (int b=0; b<a; ++b)
+		{
+			double sum = a_L[a*a_N + b];
+			for (int k=0; k<b; ++k)
+				sum -= a_L[a*a_N + k]*a_L[b*a_N + k];
+			a_L[a*a_N + b] = sum/a_L[b*a_N + b];
+		}
+
+		double sum = a_L[a*a_N + a];
+		for (int k=0; k<a; ++k)
+			sum -= a_L[a*a_N + k]*a_L[a*a_N + k];
+		if (!(sum > 0))
+			return false;
+
+		a_L[a*a_N + a] = sqrt(sum);
+	}
+
+	return true;
+}
+
+double Preconditioner_blockJacobi::get_shift() const
+{
+	return this->shift;
+}
+
+/******************************************************************************
+ * __apply__
+ * 
+ * @details 	Solves with every block and adds up the results, so that a DoF
+ * 				in several blocks gets the sum of their corrections.
+ * 
+ * @param[in] a_r 		The residual.
+ * @param[out] a_z 		M^{-1} r.
+ ******************************************************************************/
+void Preconditioner_blockJacobi::apply(const std::vector<double> &a_r, std::vector<double> &a_z) const
+{
+	a_z.assign(a_r.size(), 0);
+
+	int noBlocks = this->blockStarts.size() - 1;
+	std::vector<double> &y = this->y;
+
+	for (int i=0; i<noBlocks; ++i)
+	{
+		const int* DoFs = &this->blockDoFs[this->blockStarts[i]];
+		int N = this->blockStarts[i+1] - this->blockStarts[i];
+		const double* L = &this->factors[this->factorStarts[i]];
+
+		// Solves L y = r, then L^T z = y.
+		y.resize(N);
+		for (int a=0; a<N; ++a)
+		{
+			double sum = a_r[DoFs[a]];
+			for (int k=0; k<a; ++k)
+				sum -= L[a*N + k]*y[k];
+			y[a] = sum/L[a*N + a];
+		}
+
+		for (int a=N-1; a>=0; --a)
+		{
+			double sum = y[a];
+			for (int k=a+1; k<N; ++k)
+				sum -= L[k*N + a]*y[k];
+			y[a] = sum/L[a*N + a];
+		}
+
+		for (int a=0; a<N; ++a)
+			a_z[DoFs[a]] += y[a];
+	}
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+/******************************************************************************
+ * @details Declarations for [Preconditioner_blockJacobi].
+ * 
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/16
+ ******************************************************************************/
+#ifndef CLASS_PRECONDITIONER_BLOCKJACOBI
+#define CLASS_PRECONDITIONER_BLOCKJACOBI
+
+#include "matrix_sparse.hpp"
+#include "preconditioner.hpp"
+#include <vector>
+
+// M^{-1} is the sum over blocks of the DoFs, e.g. one per element, of the
+//  inverse of A's diagonal block for them. Without overlap this is block
+//  Jacobi; with it, additive Schwarz. Each block is factorised by a dense
+//  Cholesky decomposition.
+class Preconditioner_blockJacobi: public Preconditioner
+{
+	private:
+		// Block i holds DoFs blockDoFs[blockStarts[i]] to
+		//  blockDoFs[blockStarts[i+1]-1].
+		std::vector<int> blockStarts;
+		std::vector<int> blockDoFs;
+
+		// Cholesky factor of each block, row by row, starting at
+		//  factorStarts[i].
+		std::vector<int>    factorStarts;
+		std::vector<double> factors;
+
+		// The largest shift of a block's diagonal its factorisation needed.
+		double shift = 0;
+
+		// Scratch space for apply, as long as the largest block.
+		mutable std::vector<double> y;
+
+		static bool factorise(const int &a_N, double a_L[]);
+
+	public:
+		Preconditioner_blockJacobi(const Matrix_sparse<double> &a_matrix, const std::vector<int> &a_blockStarts, const std::vector<int> &a_blockDoFs);
+
+		void apply(const std::vector<double> &a_r, std::vector<double> &a_z) const;
+
+		double get_shift() const;
+};
+
+#endif
\ No newline at end of file
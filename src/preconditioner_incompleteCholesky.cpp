@@ -0,0 +1,151 @@
+/******************************************************************************
+ * @details This is a file containing definitions of
+ * 				[Preconditioner_incompleteCholesky].
+ * 
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/16
+ ******************************************************************************/
+#include "matrix_sparse.hpp"
+#include "preconditioner_incompleteCholesky.hpp"
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+/******************************************************************************
+ * __Preconditioner_incompleteCholesky__
+ * 
+ * @details 	Takes the lower triangle of A and factorises it. IC(0) can
+ * 				break down with a pivot that is not positive even for a
+ * 				symmetric positive definite A; it is then started again on A
+ * 				with its diagonal scaled by 1 + shift, the shift doubling
+ * 				from 1e-3 until every pivot is positive (Manteuffel). The
+ * 				shift used is kept, for get_shift.
+ * 
+ * @param[in] a_matrix 		A symmetric matrix with columns in ascending
+ * 							 order in each row and every diagonal entry
+ * 							 stored.
+ ******************************************************************************/
+Preconditioner_incompleteCholesky::Preconditioner_incompleteCholesky(const Matrix_sparse<double> &a_matrix)
+{
+	const std::vector<int>    &rowStarts = a_matrix.get_rowStarts();
+	const std::vector<int>    &columnNos = a_matrix.get_columnNos();
+	const std::vector<double> &entries   = a_matrix.get_matrixEntries();
+
+	int n = a_matrix.get_noRows();
+
+	// The lower triangle of A.
+	this->rowStarts.resize(n+1, 0);
+	for (int i=0; i<n; ++i)
+	{
+		for (int index=rowStarts[i]; index<rowStarts[i+1] && columnNos[index]<=i; ++index)
+		{
+			this->columnNos.push_back(columnNos[index]);
+			this->entries  .push_back(entries[index]);
+		}
+		this->rowStarts[i+1] = this->columnNos.size();
+	}
+
+	// A large enough shift makes A diagonally dominant, when IC(0) cannot
+	//  break down, as long as the diagonal is positive.
+	for (int i=0; i<n; ++i)
+		assert(this->entries[this->rowStarts[i+1]-1] > 0);
+
+	std::vector<double> lower = this->entries;
+	while (!this->factorise())
+	{
+		this->shift = (this->shift == 0)?1e-3:2*this->shift;
+
+		this->entries = lower;
+		for (int i=0; i<n; ++i)
+			this->entries[this->rowStarts[i+1]-1] *= 1 + this->shift;
+	}
+}
+
+/******************************************************************************
+ * __factorise__
+ * 
+ * @details 	Factorises the lower triangle held in place row by row, each
+ * 				entry needing the sparse dot product of two earlier rows of
+ * 				L.
+ * 
+ * @return 		Whether every pivot was positive.
+ ******************************************************************************/
+bool Preconditioner_incompleteCholesky::factorise()
+{
+	int n = this->rowStarts.size() - 1;
+
+	for (int i=0; i<n; ++i)
+	{
+		int start = this->rowStarts[i];
+		int end   = this->rowStarts[i+1];
+
+		assert(end > start && this->columnNos[end-1] == i);
+
+		// Off-diagonal entries, L(i, k) = (A(i, k) - sum_j<k L(i, j)L(k, j))/L(k, k).
+		for (int index=start; index<end-1; ++index)
+		{
+			int k = this->columnNos[index];
+
+			double sum = this->entries[index];
+			int indexI = start;
+			int indexK = this->rowStarts[k];
+			while (indexI < index && indexK < this->rowStarts[k+1]-1)
+			{
+				int columnI = this->columnNos[indexI];
+				int columnK = this->columnNos[indexK];
+
+				if (columnI == columnK)
+					sum -= this->entries[indexI++]*this->entries[indexK++];
+				else if (columnI < columnK)
+					++indexI;
+				else
+					++indexK;
+			}
+
+			this->entries[index] = sum/this->entries[this->rowStarts[k+1]-1];
+		}
+
+		// Diagonal entry.
+		double sum = this->entries[end-1];
+		for (int index=start; index<end-1; ++index)
+			sum -= this->entries[index]*this->entries[index];
+		if (!(sum > 0))
+			return false;
+
+		this->entries[end-1] = sqrt(sum);
+	}
+
+	return true;
+}
+
+double Preconditioner_incompleteCholesky::get_shift() const
+{
+	return this->shift;
+}
+
+void Preconditioner_incompleteCholesky::apply(const std::vector<double> &a_r, std::vector<double> &a_z) const
+{
+	int n = this->rowStarts.size() - 1;
+	a_z = a_r;
+
+	// Solves L y = r.
+	for (int i=0; i<n; ++i)
+	{
+		int end = this->rowStarts[i+1];
+
+		double sum = a_z[i];
+		for (int index=this->rowStarts[i]; index<end-1; ++index)
+			sum -= this->entries[index]*a_z[this->columnNos[index]];
+		a_z[i] = sum/this->entries[end-1];
+	}
+
+	// Solves L^T z = y, a column of L^T at a time.
+	for (int i=n-1; i>=0; --i)
+	{
+		int end = this->rowStarts[i+1];
+
+		a_z[i] /= this->entries[end-1];
+		for (int index=this->rowStarts[i]; index<end-1; ++index)
+			a_z[this->columnNos[index]] -= this->entries[index]*a_z[i];
+	}
+}
\ No newline at end of file
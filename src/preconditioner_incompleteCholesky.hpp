@@ -0,0 +1,37 @@
+/******************************************************************************
+ * @details Declarations for [Preconditioner_incompleteCholesky].
+ * 
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/16
+ ******************************************************************************/
+#ifndef CLASS_PRECONDITIONER_INCOMPLETECHOLESKY
+#define CLASS_PRECONDITIONER_INCOMPLETECHOLESKY
+
+#include "matrix_sparse.hpp"
+#include "preconditioner.hpp"
+#include <vector>
+
+// IC(0): M = LL^T, where L is the Cholesky factor of A with all fill-in
+//  outside the lower triangle of A's sparsity pattern dropped.
+class Preconditioner_incompleteCholesky: public Preconditioner
+{
+	private:
+		// L in CSR form; each row ends with its diagonal.
+		std::vector<int>    rowStarts;
+		std::vector<int>    columnNos;
+		std::vector<double> entries;
+
+		// How much A's diagonal was scaled up by to avoid a breakdown.
+		double shift = 0;
+
+		bool factorise();
+
+	public:
+		Preconditioner_incompleteCholesky(const Matrix_sparse<double> &a_matrix);
+
+		void apply(const std::vector<double> &a_r, std::vector<double> &a_z) const;
+
+		double get_shift() const;
+};
+
+#endif
\ No newline at end of file
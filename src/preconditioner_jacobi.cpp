@@ -0,0 +1,29 @@
+/******************************************************************************
+ * @details This is a file containing definitions of [Preconditioner_jacobi].
+ * 
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/16
+ ******************************************************************************/
+#include "preconditioner_jacobi.hpp"
+#include <vector>
+
+/******************************************************************************
+ * __Preconditioner_jacobi__
+ * 
+ * @param[in] a_diagonal 	The diagonal of the matrix.
+ ******************************************************************************/
+Preconditioner_jacobi::Preconditioner_jacobi(const std::vector<double> &a_diagonal)
+{
+	this->inverseDiagonal.resize(a_diagonal.size());
+
+	for (int i=0; i<a_diagonal.size(); ++i)
+		this->inverseDiagonal[i] = 1/a_diagonal[i];
+}
+
+void Preconditioner_jacobi::apply(const std::vector<double> &a_r, std::vector<double> &a_z) const
+{
+	a_z.resize(a_r.size());
+
+	for (int i=0; i<a_r.size(); ++i)
+		a_z[i] = this->inverseDiagonal[i]*a_r[i];
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+/******************************************************************************
+ * @details Declarations for [Preconditioner_jacobi].
+ * 
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/16
+ ******************************************************************************/
+#ifndef CLASS_PRECONDITIONER_JACOBI
+#define CLASS_PRECONDITIONER_JACOBI
+
+#include "preconditioner.hpp"
+#include <vector>
+
+// M = diag(A).
+class Preconditioner_jacobi: public Preconditioner
+{
+	private:
+		std::vector<double> inverseDiagonal;
+
+	public:
+		Preconditioner_jacobi(const std::vector<double> &a_diagonal);
+
+		void apply(const std::vector<double> &a_r, std::vector<double> &a_z) const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,197 @@
+/******************************************************************************
+ * @details This is a file containing definitions of [Preconditioner_multigrid].
+ * 
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/25
+ ******************************************************************************/
+#include "linearSystems.hpp"
+#include "matrix_banded.hpp"
+#include "matrix_sparse.hpp"
+#include "preconditioner_multigrid.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	std::vector<Matrix_sparse<double>> get_transposes(const std::vector<Matrix_sparse<double>> &a_matrices)
+	{
+		std::vector<Matrix_sparse<double>> transposes;
+		transposes.reserve(a_matrices.size());
+
+		for (const Matrix_sparse<double> &matrix : a_matrices)
+			transposes.push_back(matrix.get_transpose());
+
+		return transposes;
+	}
+
+	// A, then P^T A P for each prolongation from the finest down, returned
+	//  coarsest first.
+	std::vector<Matrix_sparse<double>> compute_galerkinMatrices(const Matrix_sparse<double> &a_matrix, const std::vector<Matrix_sparse<double>> &a_prolongations, const std::vector<Matrix_sparse<double>> &a_restrictions)
+	{
+		int noLevels = a_prolongations.size() + 1;
+
+		std::vector<Matrix_sparse<double>> finestFirst;
+		finestFirst.reserve(noLevels);
+		finestFirst.push_back(a_matrix);
+
+		for (int level=noLevels-2; level>=0; --level)
+		{
+			assert(a_prolongations[level].get_noRows() == finestFirst.back().get_noColumns());
+
+			finestFirst.push_back(a_restrictions[level].get_product(finestFirst.back().get_product(a_prolongations[level])));
+		}
+
+		std::vector<Matrix_sparse<double>> matrices;
+		matrices.reserve(noLevels);
+		for (int level=noLevels-1; level>=0; --level)
+			matrices.push_back(finestFirst[level]);
+
+		return matrices;
+	}
+}
+
+/******************************************************************************
+ * __Preconditioner_multigrid__
+ * 
+ * @details 	Forms the coarser matrices, factorises the coarsest and picks
+ * 				the Jacobi damping of each level as 4/3 over Gershgorin's
+ * 				bound on the largest eigenvalue of D^{-1}A, which keeps the
+ * 				smoother convergent for any degree. With no prolongations
+ * 				the cycle is a direct solve.
+ * 
+ * @param[in] a_matrix 			The symmetric positive definite matrix A.
+ * @param[in] a_prolongations 	From each level to the next finer one,
+ * 								 coarsest first; the last has as many rows
+ * 								 as A.
+ * @param[in] a_cycle 			V or W.
+ * @param[in] a_noSmoothingSteps 	Jacobi steps before and after each
+ * 									 coarse correction.
+ ******************************************************************************/
+Preconditioner_multigrid::Preconditioner_multigrid(const Matrix_sparse<double> &a_matrix, const std::vector<Matrix_sparse<double>> &a_prolongations, const linearSystems::Cycle &a_cycle, const int &a_noSmoothingSteps)
+: prolongations(a_prolongations),
+  restrictions(get_transposes(a_prolongations)),
+  matrices(compute_galerkinMatrices(a_matrix, a_prolongations, restrictions)),
+  coarseMatrix(matrices.front())
+{
+	this->cycle            = a_cycle;
+	this->noSmoothingSteps = a_noSmoothingSteps;
+
+	this->coarseMatrix.factorise();
+
+	int noLevels = this->matrices.size();
+	this->smoothingWeights.resize(noLevels);
+	this->x.resize(noLevels);
+	this->b.resize(noLevels);
+	this->r.resize(noLevels);
+
+	for (int level=1; level<noLevels; ++level)
+	{
+		const Matrix_sparse<double> &matrix = this->matrices[level];
+		const std::vector<int>    &rowStarts = matrix.get_rowStarts();
+		const std::vector<int>    &columnNos = matrix.get_columnNos();
+		const std::vector<double> &entries   = matrix.get_matrixEntries();
+
+		std::vector<double> diagonal = matrix.get_diagonal();
+
+		double largestEigenvalue = 0;
+		for (int j=0; j<diagonal.size(); ++j)
+		{
+			double rowSum = 0;
+			for (int index=rowStarts[j]; index<rowStarts[j+1]; ++index)
+				rowSum += fabs(entries[index])/sqrt(diagonal[j]*diagonal[columnNos[index]]);
+
+			largestEigenvalue = std::max(largestEigenvalue, rowSum);
+		}
+
+		double damping = 4/(3*largestEigenvalue);
+
+		this->smoothingWeights[level].resize(diagonal.size());
+		for (int j=0; j<diagonal.size(); ++j)
+			this->smoothingWeights[level][j] = damping/diagonal[j];
+	}
+}
+
+int Preconditioner_multigrid::get_noLevels() const
+{
+	return this->matrices.size();
+}
+
+/******************************************************************************
+ * __apply_smoother__
+ * 
+ * @details 	One damped Jacobi step on x for the right-hand side b of the
+ * 				level, which needs no product if x is still zero.
+ ******************************************************************************/
+void Preconditioner_multigrid::apply_smoother(const int &a_level, const bool &a_fromZero) const
+{
+	std::vector<double> &x = this->x[a_level];
+	std::vector<double> &b = this->b[a_level];
+	std::vector<double> &r = this->r[a_level];
+	const std::vector<double> &weights = this->smoothingWeights[a_level];
+
+	if (a_fromZero)
+	{
+		x.resize(b.size());
+		for (int j=0; j<b.size(); ++j)
+			x[j] = weights[j]*b[j];
+
+		return;
+	}
+
+	this->matrices[a_level].multiply(x, r);
+	for (int j=0; j<b.size(); ++j)
+		x[j] += weights[j]*(b[j] - r[j]);
+}
+
+/******************************************************************************
+ * __apply_cycle__
+ * 
+ * @details 	Sets x to the cycle's approximation of the solution for b on
+ * 				the level. Each coarse correction is for the residual left by
+ * 				the previous one, so the W-cycle's second visit continues the
+ * 				first.
+ ******************************************************************************/
+void Preconditioner_multigrid::apply_cycle(const int &a_level) const
+{
+	if (a_level == 0)
+	{
+		this->coarseMatrix.solve(this->b[0], this->x[0]);
+		return;
+	}
+
+	std::vector<double> &x = this->x[a_level];
+	std::vector<double> &b = this->b[a_level];
+	std::vector<double> &r = this->r[a_level];
+
+	for (int step=0; step<this->noSmoothingSteps; ++step)
+		this->apply_smoother(a_level, step == 0);
+	if (this->noSmoothingSteps == 0)
+		x.assign(b.size(), 0);
+
+	for (int visit=0; visit<this->cycle; ++visit)
+	{
+		this->matrices[a_level].multiply(x, r);
+		for (int j=0; j<b.size(); ++j)
+			r[j] = b[j] - r[j];
+
+		this->restrictions[a_level-1].multiply(r, this->b[a_level-1]);
+		this->apply_cycle(a_level-1);
+
+		this->prolongations[a_level-1].multiply(this->x[a_level-1], r);
+		linearSystems::axpy(1, r, x);
+	}
+
+	for (int step=0; step<this->noSmoothingSteps; ++step)
+		this->apply_smoother(a_level, false);
+}
+
+void Preconditioner_multigrid::apply(const std::vector<double> &a_r, std::vector<double> &a_z) const
+{
+	int finest = this->matrices.size() - 1;
+
+	this->b[finest] = a_r;
+	this->apply_cycle(finest);
+	a_z = this->x[finest];
+}
\ No newline at end of file
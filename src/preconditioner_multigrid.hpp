@@ -0,0 +1,55 @@
+/******************************************************************************
+ * @details Declarations for [Preconditioner_multigrid].
+ * 
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/25
+ ******************************************************************************/
+#ifndef CLASS_PRECONDITIONER_MULTIGRID
+#define CLASS_PRECONDITIONER_MULTIGRID
+
+#include "linearSystems.hpp"
+#include "matrix_banded.hpp"
+#include "matrix_sparse.hpp"
+#include "preconditioner.hpp"
+#include <vector>
+
+// M^{-1} is one multigrid cycle from zero over nested spaces, e.g. those of
+//  the meshes refinement made the current one from. The coarser matrices
+//  are the Galerkin products P^T A P, damped Jacobi smooths before and
+//  after each coarse correction, and the coarsest level is solved by banded
+//  LDL^T. The cycle is symmetric, so M is fit for CG.
+class Preconditioner_multigrid: public Preconditioner
+{
+	private:
+		// From each level to the next finer one, coarsest first, and their
+		//  transposes.
+		std::vector<Matrix_sparse<double>> prolongations;
+		std::vector<Matrix_sparse<double>> restrictions;
+
+		// The matrix of each level, coarsest first; the finest is A.
+		std::vector<Matrix_sparse<double>> matrices;
+		Matrix_banded<double> coarseMatrix;
+
+		// Damped inverse diagonal of each level.
+		std::vector<std::vector<double>> smoothingWeights;
+
+		linearSystems::Cycle cycle;
+		int noSmoothingSteps;
+
+		// Scratch space for each level.
+		mutable std::vector<std::vector<double>> x;
+		mutable std::vector<std::vector<double>> b;
+		mutable std::vector<std::vector<double>> r;
+
+		void apply_smoother(const int &a_level, const bool &a_fromZero) const;
+		void apply_cycle(const int &a_level) const;
+
+	public:
+		Preconditioner_multigrid(const Matrix_sparse<double> &a_matrix, const std::vector<Matrix_sparse<double>> &a_prolongations, const linearSystems::Cycle &a_cycle = linearSystems::VCycle, const int &a_noSmoothingSteps = 2);
+
+		int get_noLevels() const;
+
+		void apply(const std::vector<double> &a_r, std::vector<double> &a_z) const;
+};
+
+#endif
\ No newline at end of file
@@ -6,20 +6,115 @@
  ******************************************************************************/
 #include "common.hpp"
 #include "quadrature.hpp"
+#include "quadrature_tables.hpp"
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cmath>
 #include <functional>
-#include <map>
+#include <limits>
+#include <mutex>
+#include <vector>
 
 #include <iostream>
 
 namespace quadrature
 {
-	// Cached storage.
+	// Cached storage. Rules with up to tables::maxNoPoints points are baked
+	//  into the binary. Larger rules are generated once, stored contiguously,
+	//  and published with a release store so that readers never take the lock;
+	//  they live until the program exits.
 	namespace
 	{
-		std::map<std::pair<int, int>, double> integrationPoints;
-		std::map<std::pair<int, int>, double> weights;
+		struct TabulatedRules
+		{
+			Rule rules[tables::maxNoPoints+1];
+		};
+
+		constexpr TabulatedRules make_tabulatedRules()
+		{
+			TabulatedRules tabulatedRules = {};
+
+			for (int n=1; n<=tables::maxNoPoints; ++n)
+				tabulatedRules.rules[n] = Rule{
+					n,
+					tables::gaussLegendre.points  + tables::offset(n),
+					tables::gaussLegendre.weights + tables::offset(n)
+				};
+
+			return tabulatedRules;
+		}
+
+		constexpr TabulatedRules tabulatedRules = make_tabulatedRules();
+
+		const int maxGeneratedPoints = 1024;
+
+		std::atomic<const Rule*> rules[maxGeneratedPoints+1];
+		std::atomic<const Rule*> lobattoRules[maxGeneratedPoints+1];
+		std::mutex               rulesMutex;
+
+		// Returns a_rules[n], generating it with a_generator if this is the
+		//  first request.
+		const Rule& get_generatedRule(std::atomic<const Rule*> a_rules[], void (*a_generator)(const int&, double[], double[]), const int &a_n)
+		{
+			const Rule* rule = a_rules[a_n].load(std::memory_order_acquire);
+			if (rule != nullptr)
+				return *rule;
+
+			std::lock_guard<std::mutex> lock(rulesMutex);
+
+			rule = a_rules[a_n].load(std::memory_order_relaxed);
+			if (rule == nullptr)
+			{
+				double* storage = new double[2*a_n];
+				a_generator(a_n, storage, storage + a_n);
+
+				rule = new Rule{a_n, storage, storage + a_n};
+				a_rules[a_n].store(rule, std::memory_order_release);
+			}
+
+			return *rule;
+		}
+	}
+
+	/******************************************************************************
+	 * legendrePolynomials
+	 * 
+	 * @details    Evaluates the derivatives 0..i of the Legendre polynomials of
+	 * 				degrees 0..n at the point x in one sweep; see
+	 * 				tables::legendrePolynomials, which is shared with the
+	 * 				compile-time tables.
+	 *
+	 * @param[in] a_n 			The highest degree of polynomial.
+	 * @param[in] a_i 			The highest derivative.
+	 * @param[in] a_x 			The point at which to evaluate the polynomials.
+	 * @param[out] a_values 	(i+1)*(n+1) values, with P_m^{(j)}(x) stored at
+	 * 							 a_values[j*(n+1) + m].
+	 ******************************************************************************/
+	void legendrePolynomials(const int &a_n, const int &a_i, const double &a_x, double a_values[])
+	{
+		tables::legendrePolynomials(a_n, a_i, a_x, a_values);
+	}
+
+	/******************************************************************************
+	 * legendrePolynomial
+	 * 
+	 * @details    Evaluates the ith derivative of the nth Legendre polynomial.
+	 *
+	 * @param[in] a_n 			Gives the degree of the polynomial.
+	 * @param[in] a_i 			The ith derivative.
+	 * @param[in] a_x 			The point at which to evaluate the polynomial.
+	 * @return 					The value of the derivative at x.
+	 ******************************************************************************/
+	double legendrePolynomial(const int &a_n, const int &a_i, const double &a_x)
+	{
+		if (a_i > a_n)
+			return 0;
+
+		std::vector<double> values((a_i+1)*(a_n+1));
+		legendrePolynomials(a_n, a_i, a_x, values.data());
+
+		return values[a_i*(a_n+1) + a_n];
 	}
 
 	/******************************************************************************
@@ -29,91 +124,77 @@ namespace quadrature
 	 *
 	 * @param[in] n 			Gives the degree of the polynomial.
 	 * @param[in] i 			The ith derivative.
-	 * @param[in] x 			The point at which to evaluate the polynomial.
 	 * @return 					The Legendre polynomial.
 	 ******************************************************************************/
 	f_double legendrePolynomial(const int &a_n, const int &a_i)
 	{
-		if (a_i==0)
+		return [a_n, a_i](double x)->double
 		{
-			switch(a_n)
-			{
-				case 0: return[](double x)->double
-					{
-						return 1;
-					};
-					break;
-				case 1: return[](double x)->double
-					{
-						return x;
-					};
-					break;
-				default: return[a_n](double x)->double
-					{
-						using namespace common;
-
-						return 	addFunction(
-									constantMultiplyFunction(
-										double(2*a_n-1)/a_n * x,
-										legendrePolynomial(a_n-1, 0)
-									),
-									constantMultiplyFunction(
-										-1,
-										constantMultiplyFunction(
-											double(a_n-1)/a_n,
-											legendrePolynomial(a_n-2, 0)
-										)
-									)
-								)(x);
-					};
-			}
-		}
-		else
+			return legendrePolynomial(a_n, a_i, x);
+		};
+	}
+
+	/******************************************************************************
+	 * gaussLobattoRule
+	 * 
+	 * @details    Generates the n-point Gauss-Lobatto-Legendre rule. The end
+	 * 				points are -1 and 1 and the interior points are the roots of
+	 * 				P_{n-1}', found by Newton iteration from the Chebyshev-Lobatto
+	 * 				points. The weights are 2/(n(n-1)P_{n-1}(x)^2). The rule is
+	 * 				exact for polynomials of degree 2n-3.
+	 *
+	 * @param[in] a_n 			The number of points; at least 2.
+	 * @param[out] a_points 	The n points in ascending order.
+	 * @param[out] a_weights 	The n weights.
+	 ******************************************************************************/
+	void gaussLobattoRule(const int &a_n, double a_points[], double a_weights[])
+	{
+		assert(a_n >= 2);
+
+		const double eps = std::numeric_limits<double>::epsilon();
+		const int    N   = a_n - 1;
+
+		std::vector<double> P(3*(N+1));
+
+		// Only the negative half is computed; the rule is symmetric.
+		for (int i=0; i<(a_n+1)/2; ++i)
 		{
-			switch(a_n)
+			double x = -1;
+
+			if (i > 0)
 			{
-				case 0: return[](double x)->double
-					{
-						return 0;
-					};
-					break;
-				case 1: return[a_i](double x)->double
-					{
-						return (a_i==1)?1:0;
-					};
-					break;
-				default: return[a_n, a_i](double x)->double
-					{
-						using namespace common;
-
-						return 	addFunction(
-									addFunction(
-										constantMultiplyFunction(
-											double(2*a_n-1)/(a_n-1) * x,
-											legendrePolynomial(a_n-1, a_i)
-										),
-										constantMultiplyFunction(
-											-1,
-											constantMultiplyFunction(
-												double(a_n)/(a_n-1),
-												legendrePolynomial(a_n-2, a_i)
-											)
-										)
-									),
-									constantMultiplyFunction(
-										(a_i-1) * double(2*a_n-1)/(a_n-1),
-										legendrePolynomial(a_n-1, a_i-1)
-									)
-								)(x);
-					};
+				x = -cos(M_PI*i/N);
+
+				for (int k=0; k<100; ++k)
+				{
+					legendrePolynomials(N, 2, x, P.data());
+					double update = P[(N+1) + N]/P[2*(N+1) + N];
+					x -= update;
+
+					if (fabs(update) <= 2*eps)
+						break;
+				}
 			}
+
+			if (2*i == N)
+				x = 0;
+
+			legendrePolynomials(N, 0, x, P.data());
+			double w = 2/(N*a_n*P[N]*P[N]);
+
+			a_points [N-i] = -x;
+			a_points [i]   = x;
+			a_weights[N-i] = w;
+			a_weights[i]   = w;
 		}
 	}
 
 	/******************************************************************************
-	 * legendrePolynomialRoots
+	 * legendrePolynomialRoot
 	 * 
-	 * @details    Calculates the ith root of the nth degree Legendre polynomial.
+	 * @details    Calculates the ith root of the nth degree Legendre polynomial
+	 * 				by Newton iteration, stopping once the update has reached
+	 * 				round-off.
 	 *
 	 * @param[in] n 			Gives the degree of the polynomial.
 	 * @param[in] i 			Which root to return.
@@ -122,13 +203,155 @@ namespace quadrature
 	double legendrePolynomialRoot(const int n, const int i)
 	{
 		double root = -cos(double(2*i + 1)/(2*n)*M_PI);
+		double update;
+
+		std::vector<double> P(2*(n+1));
 
-		while (fabs(legendrePolynomial(n, 0)(root)) >= 1e-5)
-			root = root - legendrePolynomial(n, 0)(root)/legendrePolynomial(n, 1)(root);
+		for (int k=0; k<100; ++k)
+		{
+			legendrePolynomials(n, 1, root, P.data());
+			update = P[n]/P[2*n+1];
+			root = root - update;
+
+			if (fabs(update) <= 2*std::numeric_limits<double>::epsilon())
+				break;
+		}
 
 		return root;
 	}
 
+	/******************************************************************************
+	 * gaussLegendreRule
+	 * 
+	 * @details    Generates the n-point Gauss-Legendre rule by the Golub-Welsch
+	 * 				algorithm: the nodes are the eigenvalues of the symmetric
+	 * 				tridiagonal Jacobi matrix of the Legendre recurrence, found by
+	 * 				implicit QL in O(n^2), and the weights come from the first
+	 * 				components of its eigenvectors. Each node is then polished
+	 * 				with a Newton step and the weight recomputed from
+	 * 				2/((1-x^2)P_n'(x)^2), and the rule is symmetrised, so both are
+	 * 				accurate to double precision.
+	 *
+	 * @param[in] a_n 			The number of points.
+	 * @param[out] a_points 	The n points in ascending order.
+	 * @param[out] a_weights 	The n weights.
+	 ******************************************************************************/
+	void gaussLegendreRule(const int &a_n, double a_points[], double a_weights[])
+	{
+		const double eps = std::numeric_limits<double>::epsilon();
+
+		// Jacobi matrix; e[i] couples d[i] and d[i+1]. z is the first row of
+		//  the eigenvector matrix.
+		std::vector<double> d(a_n, 0);
+		std::vector<double> e(a_n, 0);
+		std::vector<double> z(a_n, 0);
+		z[0] = 1;
+		for (int k=1; k<a_n; ++k)
+			e[k-1] = k/sqrt(double(4*k*k - 1));
+
+		// Implicit QL with Wilkinson shifts.
+		for (int l=0; l<a_n; ++l)
+		{
+			int iteration = 0;
+			int m;
+
+			do
+			{
+				for (m=l; m<a_n-1; ++m)
+					if (fabs(e[m]) <= eps*(fabs(d[m]) + fabs(d[m+1])))
+						break;
+
+				if (m != l)
+				{
+					assert(++iteration <= 60);
+
+					double g = (d[l+1] - d[l])/(2*e[l]);
+					double r = hypot(g, double(1));
+					g = d[m] - d[l] + e[l]/(g + copysign(r, g));
+
+					double s = 1;
+					double c = 1;
+					double p = 0;
+
+					int i;
+					for (i=m-1; i>=l; --i)
+					{
+						double f = s*e[i];
+						double b = c*e[i];
+						r = hypot(f, g);
+						e[i+1] = r;
+
+						if (r == 0)
+						{
+							d[i+1] -= p;
+							e[m] = 0;
+							break;
+						}
+
+						s = f/r;
+						c = g/r;
+						g = d[i+1] - p;
+						r = (d[i] - g)*s + 2*c*b;
+						p = s*r;
+						d[i+1] = g + p;
+						g = c*r - b;
+
+						f = z[i+1];
+						z[i+1] = s*z[i] + c*f;
+						z[i]   = c*z[i] - s*f;
+					}
+
+					if (r == 0 && i >= l)
+						continue;
+
+					d[l] -= p;
+					e[l] = g;
+					e[m] = 0;
+				}
+			} while (m != l);
+		}
+
+		// Sorts into ascending order.
+		std::vector<int> order(a_n);
+		for (int i=0; i<a_n; ++i)
+			order[i] = i;
+		std::sort(order.begin(), order.end(), [&d](int a, int b) { return d[a] < d[b]; });
+
+		for (int i=0; i<a_n; ++i)
+		{
+			a_points [i] = d[order[i]];
+			a_weights[i] = 2*pow(z[order[i]], 2);
+		}
+
+		// Newton polish and weights from the derivative.
+		std::vector<double> P(2*(a_n+1));
+		for (int i=0; i<a_n; ++i)
+		{
+			double x = a_points[i];
+
+			legendrePolynomials(a_n, 1, x, P.data());
+			x -= P[a_n]/P[2*a_n+1];
+			legendrePolynomials(a_n, 1, x, P.data());
+
+			a_points [i] = x;
+			a_weights[i] = double(2) / ((1 - pow(x, 2))*pow(P[2*a_n+1], 2));
+		}
+
+		// Symmetrises.
+		for (int i=0; i<a_n/2; ++i)
+		{
+			double x = (a_points [a_n-1-i] - a_points [i])/2;
+			double w = (a_weights[a_n-1-i] + a_weights[i])/2;
+
+			a_points [i]       = -x;
+			a_points [a_n-1-i] =  x;
+			a_weights[i]       =  w;
+			a_weights[a_n-1-i] =  w;
+		}
+		if (a_n % 2 == 1)
+			a_points[a_n/2] = 0;
+	}
+
 	/******************************************************************************
 	 * legendrePolynomialRoots
 	 * 
@@ -158,16 +381,11 @@ namespace quadrature
 	 ******************************************************************************/
 	double gaussLegendreQuadrature(const f_double f, const int n)
 	{
-		double weight, x;
-		double h = double(2)/n;
+		const Rule &rule = get_gaussLegendreRule(n);
 		double quadrature = 0;
 
 		for (int i=0; i<n; ++i)
-		{
-			x = legendrePolynomialRoot(n, i);
-			weight = double(2) / ((1 - pow(x, 2))*pow(legendrePolynomial(n, 1)(x), 2));
-			quadrature += weight * f(x);
-		}
+			quadrature += rule.weights[i] * f(rule.points[i]);
 
 		return quadrature;
 	}
@@ -198,24 +416,85 @@ namespace quadrature
 		return h/(n-1) * answer;
 	}
 
-	double get_gaussLegendrePoint(const int &a_n, const int &a_i)
+	/******************************************************************************
+	 * get_gaussLegendreRule
+	 * 
+	 * @details    Returns the n-point Gauss-Legendre rule, either from the
+	 * 				compile-time tables or by generating it on first request.
+	 * 				Safe to call from multiple threads; once a rule exists,
+	 * 				lookups are a single atomic load.
+	 *
+	 * @param[in] a_n 			The number of points.
+	 * @return 					Read-only views of the points and weights.
+	 ******************************************************************************/
+	const Rule& get_gaussLegendreRule(const int &a_n)
 	{
-		if (integrationPoints.find(std::make_pair(a_n, a_i)) == integrationPoints.end())
-		{
-			integrationPoints[std::make_pair(a_n, a_i)] = legendrePolynomialRoot(a_n, a_i);
-		}
+		assert(1 <= a_n && a_n <= maxGeneratedPoints);
 
-		return integrationPoints[std::make_pair(a_n, a_i)];
+		if (a_n <= tables::maxNoPoints)
+			return tabulatedRules.rules[a_n];
+
+		return get_generatedRule(rules, gaussLegendreRule, a_n);
 	}
 
-	double get_gaussLegendreWeight(const int &a_n, const int &a_i)
+	/******************************************************************************
+	 * get_gaussLobattoRule
+	 * 
+	 * @details    Returns the n-point Gauss-Lobatto-Legendre rule, generating it
+	 * 				on first request; see get_gaussLegendreRule.
+	 *
+	 * @param[in] a_n 			The number of points; at least 2.
+	 * @return 					Read-only views of the points and weights.
+	 ******************************************************************************/
+	const Rule& get_gaussLobattoRule(const int &a_n)
 	{
-		if (weights.find(std::make_pair(a_n, a_i)) == weights.end())
-		{
-			double xi = get_gaussLegendrePoint(a_n, a_i);
-			weights[std::make_pair(a_n, a_i)] = double(2) / ((1 - pow(xi, 2))*pow(legendrePolynomial(a_n, 1)(xi), 2));
-		}
+		assert(2 <= a_n && a_n <= maxGeneratedPoints);
 
-		return weights[std::make_pair(a_n, a_i)];
+		return get_generatedRule(lobattoRules, gaussLobattoRule, a_n);
+	}
+
+	/******************************************************************************
+	 * get_rule
+	 * 
+	 * @details    Returns the n-point rule of the given family.
+	 *
+	 * @param[in] a_family 		The family of rule.
+	 * @param[in] a_n 			The number of points.
+	 * @return 					Read-only views of the points and weights.
+	 ******************************************************************************/
+	const Rule& get_rule(const Family &a_family, const int &a_n)
+	{
+		if (a_family == GaussLobatto)
+			return get_gaussLobattoRule(a_n);
+		else
+			return get_gaussLegendreRule(a_n);
+	}
+
+	/******************************************************************************
+	 * get_gaussLegendrePoint
+	 * 
+	 * @details    Returns the ith point of the n-point Gauss-Legendre rule.
+	 *
+	 * @param[in] a_n 			The number of points.
+	 * @param[in] a_i 			Which point to return.
+	 * @return 					The point.
+	 ******************************************************************************/
+	double get_gaussLegendrePoint(const int &a_n, const int &a_i)
+	{
+		return get_gaussLegendreRule(a_n).points[a_i];
+	}
+
+	/******************************************************************************
+	 * get_gaussLegendreWeight
+	 * 
+	 * @details    Returns the ith weight of the n-point Gauss-Legendre rule.
+	 *
+	 * @param[in] a_n 			The number of points.
+	 * @param[in] a_i 			Which weight to return.
+	 * @return 					The weight.
+	 ******************************************************************************/
+	double get_gaussLegendreWeight(const int &a_n, const int &a_i)
+	{
+		return get_gaussLegendreRule(a_n).weights[a_i];
 	}
 }
\ No newline at end of file
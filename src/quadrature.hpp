@@ -15,14 +15,50 @@
 
 namespace quadrature
 {
+	/******************************************************************************
+	 * Rule
+	 * 
+	 * @details    Read-only view of a quadrature rule on [-1, 1]; points and
+	 * 				weights are each stored contiguously.
+	 ******************************************************************************/
+	struct Rule
+	{
+		int           noPoints;
+		const double* points;
+		const double* weights;
+	};
+
+	// Families of rules. Gauss-Lobatto rules include both end points.
+	enum Family
+	{
+		GaussLegendre,
+		GaussLobatto
+	};
+
+	// Element integrands that can each be given their own family of rule.
+	enum Integrand
+	{
+		Stiffness,
+		Mass,
+		Load
+	};
+	const int noIntegrands = 3;
+
 	double   gaussLegendreQuadrature(const f_double f, const int n);
+	void     gaussLegendreRule(const int &a_n, double a_points[], double a_weights[]);
+	void     gaussLobattoRule(const int &a_n, double a_points[], double a_weights[]);
 	f_double legendrePolynomial(const int &a_n, const int &a_i);
+	double   legendrePolynomial(const int &a_n, const int &a_i, const double &a_x);
+	void     legendrePolynomials(const int &a_n, const int &a_i, const double &a_x, double a_values[]);
 	double   legendrePolynomialRoot(const int n, const int i);
 	void     legendrePolynomialRoots(const int n, double roots[]);
 	double   trapeziumRule(const int n, const double fValues[], const double h);
 
-	double get_gaussLegendrePoint(const int &a_n, const int &a_i);
-	double get_gaussLegendreWeight(const int &a_n, const int &a_i);
+	const Rule& get_gaussLegendreRule(const int &a_n);
+	double      get_gaussLegendrePoint(const int &a_n, const int &a_i);
+	double      get_gaussLegendreWeight(const int &a_n, const int &a_i);
+	const Rule& get_gaussLobattoRule(const int &a_n);
+	const Rule& get_rule(const Family &a_family, const int &a_n);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,151 @@
+/******************************************************************************
+ * @details This is a file containing definitions of [QuadratureCache].
+ * 
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/12
+ ******************************************************************************/
+#include "common.hpp"
+#include "element.hpp"
+#include "quadrature.hpp"
+#include "quadratureCache.hpp"
+#include <vector>
+
+/******************************************************************************
+ * __QuadratureCache__
+ * 
+ * @details 	Constructor for a cache of points only.
+ ******************************************************************************/
+QuadratureCache::QuadratureCache()
+{
+	this->offsets.resize(1, 0);
+}
+
+/******************************************************************************
+ * __QuadratureCache__
+ * 
+ * @details 	Constructor for a cache of points and coefficient values.
+ * 
+ * @param[in] a_coefficients 	The coefficient functions to evaluate.
+ ******************************************************************************/
+QuadratureCache::QuadratureCache(const std::vector<f_double> &a_coefficients)
+: QuadratureCache::QuadratureCache()
+{
+	this->coefficients = a_coefficients;
+	this->values.resize(a_coefficients.size());
+}
+
+/******************************************************************************
+ * __update__
+ * 
+ * @details 	Brings the cache up to date with a mesh. Elements whose nodes
+ * 				and polynomial degree are unchanged keep their entries; only
+ * 				new or changed elements are mapped and have their coefficients
+ * 				evaluated. Both meshes are assumed ordered left to right.
+ * 
+ * @param[in] a_elements 	The mesh.
+ * @return  				The number of elements that were recomputed.
+ ******************************************************************************/
+int QuadratureCache::update(Elements* const &a_elements)
+{
+	int n    = a_elements->get_noElements();
+	int oldN = this->leftNodes.size();
+
+	std::vector<double> leftNodes(n);
+	std::vector<double> rightNodes(n);
+	std::vector<int> polynomialDegrees(n);
+	std::vector<int> offsets(n+1);
+
+	offsets[0] = 0;
+	for (int i=0; i<n; ++i)
+	{
+		Element* currentElement = (*a_elements)[i];
+
+		leftNodes[i]         = currentElement->get_leftNode();
+		rightNodes[i]        = currentElement->get_rightNode();
+		polynomialDegrees[i] = currentElement->get_polynomialDegree();
+		offsets[i+1]         = offsets[i] + currentElement->get_noQuadraturePoints();
+	}
+
+	// Nothing to do if the mesh is unchanged.
+	if (leftNodes == this->leftNodes && rightNodes == this->rightNodes && polynomialDegrees == this->polynomialDegrees)
+		return 0;
+
+	std::vector<double> points(offsets[n]);
+	std::vector<std::vector<double>> values(this->coefficients.size(), std::vector<double>(offsets[n]));
+
+	int noRecomputed = 0;
+	int j = 0;
+	for (int i=0; i<n; ++i)
+	{
+		int start    = offsets[i];
+		int noPoints = offsets[i+1] - offsets[i];
+
+		// Finds the old element with the same left node, if any.
+		while (j < oldN && this->leftNodes[j] < leftNodes[i])
+			++j;
+
+		if (j < oldN && this->leftNodes[j] == leftNodes[i] && this->rightNodes[j] == rightNodes[i] && this->polynomialDegrees[j] == polynomialDegrees[i])
+		{
+			int oldStart = this->offsets[j];
+
+			for (int k=0; k<noPoints; ++k)
+				points[start + k] = this->points[oldStart + k];
+
+			for (int c=0; c<this->coefficients.size(); ++c)
+				for (int k=0; k<noPoints; ++k)
+					values[c][start + k] = this->values[c][oldStart + k];
+
+			continue;
+		}
+
+		Element* currentElement = (*a_elements)[i];
+		const quadrature::Rule &rule = currentElement->get_elementQuadrature();
+
+		for (int k=0; k<noPoints; ++k)
+			points[start + k] = currentElement->mapLocalToGlobal(rule.points[k]);
+
+		for (int c=0; c<this->coefficients.size(); ++c)
+			for (int k=0; k<noPoints; ++k)
+				values[c][start + k] = this->coefficients[c](points[start + k]);
+
+		++noRecomputed;
+	}
+
+	this->leftNodes         = leftNodes;
+	this->rightNodes        = rightNodes;
+	this->polynomialDegrees = polynomialDegrees;
+	this->offsets           = offsets;
+	this->points            = points;
+	this->values            = values;
+
+	return noRecomputed;
+}
+
+/******************************************************************************
+ * __get_points__
+ * 
+ * @details 	Returns the physical coordinates of the points of the ith
+ * 				element's quadrature rule, get_elementQuadrature().
+ * 
+ * @param[in] a_i 		The element.
+ * @return  			The physical coordinates.
+ ******************************************************************************/
+const double* QuadratureCache::get_points(const int &a_i) const
+{
+	return &this->points[this->offsets[a_i]];
+}
+
+/******************************************************************************
+ * __get_values__
+ * 
+ * @details 	Returns the values of a coefficient at the points of the ith
+ * 				element's quadrature rule.
+ * 
+ * @param[in] a_i 			The element.
+ * @param[in] a_coefficient Which coefficient.
+ * @return  				The coefficient values.
+ ******************************************************************************/
+const double* QuadratureCache::get_values(const int &a_i, const int &a_coefficient) const
+{
+	return &this->values[a_coefficient][this->offsets[a_i]];
+}
\ No newline at end of file
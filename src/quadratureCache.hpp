@@ -0,0 +1,42 @@
+/******************************************************************************
+ * @details This is a file containing declarations of [QuadratureCache].
+ * 
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/12
+ ******************************************************************************/
+#ifndef CLASS_QUADRATURECACHE
+#define CLASS_QUADRATURECACHE
+
+#include "common.hpp"
+#include "element.hpp"
+#include <vector>
+
+// Physical quadrature points of every element of a mesh and the values of
+//  some coefficient functions at them, kept across solves and refinements.
+class QuadratureCache
+{
+	private:
+		// Coefficient functions.
+		std::vector<f_double> coefficients;
+
+		// What each element's entries were computed for.
+		std::vector<double> leftNodes;
+		std::vector<double> rightNodes;
+		std::vector<int> polynomialDegrees;
+
+		// Element i's entries start at offsets[i].
+		std::vector<int> offsets;
+		std::vector<double> points;
+		std::vector<std::vector<double>> values;
+
+	public:
+		QuadratureCache();
+		QuadratureCache(const std::vector<f_double> &a_coefficients);
+
+		int update(Elements* const &a_elements);
+
+		const double* get_points(const int &a_i) const;
+		const double* get_values(const int &a_i, const int &a_coefficient) const;
+};
+
+#endif
\ No newline at end of file
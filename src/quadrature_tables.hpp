@@ -0,0 +1,162 @@
+/******************************************************************************
+ * @details This is a file containing the compile-time Gauss-Legendre tables
+ * 				of the [quadrature] namespace.
+ *
+ * @author     Adam Matthew Blakey
+ * @date       2020/05/06
+ ******************************************************************************/
+#ifndef NAMESPACE_QUADRATURE_TABLES
+#define NAMESPACE_QUADRATURE_TABLES
+
+namespace quadrature
+{
+	namespace tables
+	{
+		// Largest rule and element degree baked into the binary.
+		constexpr int maxNoPoints = 32;
+		constexpr int maxDegree   = 16;
+
+		// Rules are stored back to back; the n-point rule starts at offset(n).
+		constexpr int offset(const int a_n)
+		{
+			return (a_n-1)*a_n/2;
+		}
+		constexpr int noPoints = offset(maxNoPoints+1);
+
+		/******************************************************************************
+		 * sqrt
+		 *
+		 * @details    Square root by Newton iteration, usable at compile time.
+		 ******************************************************************************/
+		constexpr double sqrt(const double a_x)
+		{
+			double x = (a_x > 1)?a_x:1;
+
+			for (int k=0; k<64; ++k)
+				x = (x + a_x/x)/2;
+
+			return x;
+		}
+
+		/******************************************************************************
+		 * cos
+		 *
+		 * @details    Cosine on [0, pi] by its Taylor series, usable at compile
+		 * 				time. Only used for initial guesses.
+		 ******************************************************************************/
+		constexpr double cos(const double a_x)
+		{
+			double term = 1;
+			double sum  = 1;
+
+			for (int k=1; k<40; ++k)
+			{
+				term *= -a_x*a_x/((2*k-1)*(2*k));
+				sum  += term;
+			}
+
+			return sum;
+		}
+
+		/******************************************************************************
+		 * legendrePolynomials
+		 *
+		 * @details    Evaluates the derivatives 0..i of the Legendre polynomials of
+		 * 				degrees 0..n at the point x in one sweep. Values use Bonnet's
+		 * 				recurrence and derivatives use
+		 * 				P_m^{(j)} = P_{m-2}^{(j)} + (2m-1) P_{m-1}^{(j-1)},
+		 * 				so the cost is O(n*(i+1)).
+		 *
+		 * @param[in] a_n 			The highest degree of polynomial.
+		 * @param[in] a_i 			The highest derivative.
+		 * @param[in] a_x 			The point at which to evaluate the polynomials.
+		 * @param[out] a_values 	(i+1)*(n+1) values, with P_m^{(j)}(x) stored at
+		 * 							 a_values[j*(n+1) + m].
+		 ******************************************************************************/
+		constexpr void legendrePolynomials(const int a_n, const int a_i, const double a_x, double a_values[])
+		{
+			int N = a_n + 1;
+
+			// Values.
+			a_values[0] = 1;
+			if (a_n >= 1)
+				a_values[1] = a_x;
+			for (int m=2; m<=a_n; ++m)
+				a_values[m] = (double(2*m-1)*a_x*a_values[m-1] - double(m-1)*a_values[m-2])/m;
+
+			// Derivatives.
+			for (int j=1; j<=a_i; ++j)
+			{
+				double*       P  = &a_values[j*N];
+				const double* P_ = &a_values[(j-1)*N];
+
+				P[0] = 0;
+				if (a_n >= 1)
+					P[1] = (j==1)?1:0;
+				for (int m=2; m<=a_n; ++m)
+					P[m] = P[m-2] + (2*m-1)*P_[m-1];
+			}
+		}
+
+		/******************************************************************************
+		 * GaussLegendre
+		 *
+		 * @details    Points and weights of every rule with 1..maxNoPoints points.
+		 ******************************************************************************/
+		struct GaussLegendre
+		{
+			double points [noPoints];
+			double weights[noPoints];
+		};
+
+		constexpr GaussLegendre make_gaussLegendre()
+		{
+			GaussLegendre rules = {};
+
+			for (int n=1; n<=maxNoPoints; ++n)
+			{
+				double* x = rules.points  + offset(n);
+				double* w = rules.weights + offset(n);
+
+				// Newton from Tricomi's initial guess; the rule is symmetric, so
+				//  only the negative half is computed.
+				double P[2*(maxNoPoints+1)] = {};
+
+				for (int i=0; i<n/2; ++i)
+				{
+					double root = -cos(3.14159265358979323846*(4*i + 3)/(4*n + 2));
+
+					for (int k=0; k<100; ++k)
+					{
+						legendrePolynomials(n, 1, root, P);
+						double update = P[n]/P[2*n+1];
+						root -= update;
+
+						if (update*update <= 1e-32)
+							break;
+					}
+					legendrePolynomials(n, 1, root, P);
+
+					x[i]     = root;
+					x[n-1-i] = -root;
+					w[i]     = 2/((1 - root*root)*P[2*n+1]*P[2*n+1]);
+					w[n-1-i] = w[i];
+				}
+
+				if (n % 2 == 1)
+				{
+					legendrePolynomials(n, 1, 0, P);
+
+					x[n/2] = 0;
+					w[n/2] = 2/(P[2*n+1]*P[2*n+1]);
+				}
+			}
+
+			return rules;
+		}
+
+		inline constexpr GaussLegendre gaussLegendre = make_gaussLegendre();
+	}
+}
+
+#endif
\ No newline at end of file
@@ -46,7 +46,7 @@ namespace refinement
 		for (int i=0; i<oldNodeCoordinates.size(); ++i) // This assumes coordinates are in order.
 		{
 			newNodeCoordinates[i+j] = oldNodeCoordinates[i];
-			if (refineh[i])
+			if (i < oldNoElements && refineh[i])
 			{
 				newNodeCoordinates[i+j+1] = (oldNodeCoordinates[i] + oldNodeCoordinates[i+1])/2;
 				++j;
@@ -81,22 +81,12 @@ namespace refinement
 		}
 
 		// Creates new elements.
-		Element*** newElements;
 		Elements* elements = new Elements(
 			totalNoElements,
 			newNodeCoordinates,
-			newElements
+			newPolynomialDegrees
 		);
-
-		// Populates elements.
-		*newElements = new Element*[totalNoElements];
-		for (int i=0; i<totalNoElements; ++i)
-		{
-			std::vector<int> nodeIndices = {i, i+1};
-			(*newElements)[i] = new Element(i, 2, nodeIndices, elements->get_rawNodeCoordinates(), newPolynomialDegrees[i]);
-		}
-
-		elements->calculateDoFs();
+		elements->set_DoFOrdering(a_mesh->elements->get_DoFOrdering());
 
 		// Creates new mesh and solution.
 		*a_meshNew = new Mesh(elements);
@@ -130,7 +120,7 @@ namespace refinement
 		for (int i=0; i<oldNodeCoordinates.size(); ++i) // This assumes coordinates are in order.
 		{
 			newNodeCoordinates[i+j] = oldNodeCoordinates[i];
-			if (refine[i])
+			if (i < oldNoElements && refine[i])
 			{
 				newNodeCoordinates[i+j+1] = (oldNodeCoordinates[i] + oldNodeCoordinates[i+1])/2;
 				++j;
@@ -161,22 +151,12 @@ namespace refinement
 		}
 
 		// Creates new elements.
-		Element*** newElements;
 		Elements* elements = new Elements(
 			totalNoElements,
 			newNodeCoordinates,
-			newElements
+			newPolynomialDegrees
 		);
-
-		// Populates elements.
-		*newElements = new Element*[totalNoElements];
-		for (int i=0; i<totalNoElements; ++i)
-		{
-			std::vector<int> nodeIndices = {i, i+1};
-			(*newElements)[i] = new Element(i, 2, nodeIndices, elements->get_rawNodeCoordinates(), newPolynomialDegrees[i]);
-		}
-
-		elements->calculateDoFs();
+		elements->set_DoFOrdering(a_mesh->elements->get_DoFOrdering());
 
 		// Creates new mesh and solution.
 		*a_meshNew = new Mesh(elements);
@@ -211,23 +191,12 @@ namespace refinement
 		std::vector<double> nodeCoordinates = a_mesh->elements->get_nodeCoordinates();
 
 		// Creates new elements.
-		Element*** newElements;
 		Elements* elements = new Elements(
 			noElements,
 			nodeCoordinates,
-			newElements
+			polynomialDegrees
 		);
-
-		// Populates elements.
-		*newElements = new Element*[noElements];
-		for (int i=0; i<noElements; ++i)
-		{
-			std::vector<int> nodeIndices = {i, i+1};
-
-			(*newElements)[i] = new Element(i, 2, nodeIndices, elements->get_rawNodeCoordinates(), polynomialDegrees[i]);
-		}
-
-		elements->calculateDoFs();
+		elements->set_DoFOrdering(a_mesh->elements->get_DoFOrdering());
 
 		// Creates new mesh and solution.
 		*a_meshNew = new Mesh(elements);
@@ -238,6 +207,31 @@ namespace refinement
 			);
 	}
 
+	/******************************************************************************
+	 * __set_defaultSolver__
+	 * 
+	 * @details 	Refinement solves on meshes far finer than the first, where
+	 * 				plain CG needs a number of iterations that grows with the
+	 * 				DoF and an absolute tolerance near round-off may never be
+	 * 				reached. Unless the caller has chosen otherwise, CG is
+	 * 				preconditioned by incomplete Cholesky and also stops at
+	 * 				1e-12 of its first residual.
+	 * 
+	 * @param[in] a_solution 	The solution the refined ones are copied from.
+	 ******************************************************************************/
+	void set_defaultSolver(Solution* a_solution)
+	{
+		if (a_solution->get_preconditioning() == linearSystems::None && !a_solution->get_directSolver())
+			a_solution->set_preconditioning(linearSystems::IncompleteCholesky);
+
+		linearSystems::StoppingCriteria criteria = a_solution->get_stoppingCriteria();
+		if (criteria.relativeTolerance == 0 && criteria.maxIterations == 0)
+		{
+			criteria.relativeTolerance = 1e-12;
+			a_solution->set_stoppingCriteria(criteria);
+		}
+	}
+
 	void refinement(const Mesh* a_mesh, Mesh** a_meshNew, const Solution* a_solution, Solution** a_solutionNew, const double &a_solveTolerance, const double &a_adaptivityTolerance, const int &a_maxIterations, const bool &a_refineh, const bool &a_refinep, const bool &a_output, f_double const exact, f_double const exact_)
 	{
 		// Starting conditions.
@@ -247,6 +241,7 @@ namespace refinement
 			newSolution = new Solution_linear(*const_cast<Solution_linear*>(static_cast<const Solution_linear*>(a_solution)));
 		else
 			newSolution = new Solution_nonlinear(*const_cast<Solution_nonlinear*>(static_cast<const Solution_nonlinear*>(a_solution)));
+		set_defaultSolver(newSolution);
 
 		// Loop variables initialisation.
 		double errorIndicator, errorIndicatorPrev = 0;
@@ -270,7 +265,7 @@ namespace refinement
 			currentMesh = newMesh;
 
 			// Solve.
-			currentSolution->Solve(1e-15);
+			currentSolution->Solve(a_solveTolerance);
 
 			// Calculates new error indicator.
 			double errorIndicator = currentSolution->compute_globalErrorIndicator();
@@ -330,7 +325,7 @@ namespace refinement
 			outputFile.close();
 
 		// Solves solution.
-		currentSolution->Solve(1e-15);
+		currentSolution->Solve(a_solveTolerance);
 
 		// What we're spitting back.
 		*a_meshNew     = currentMesh;
@@ -354,6 +349,7 @@ namespace refinement
 		Solution* newSolution;
 		if (a_solution->get_linear())
 			newSolution = new Solution_linear(*const_cast<Solution_linear*>(static_cast<const Solution_linear*>(a_solution)));
+		set_defaultSolver(newSolution);
 
 		// Loop variables initialisation.
 		double errorIndicator, errorIndicatorPrev = 0;
@@ -377,7 +373,7 @@ namespace refinement
 			currentMesh = newMesh;
 
 			// Solve.
-			currentSolution->Solve(1e-15);
+			currentSolution->Solve(a_solveTolerance);
 
 			// Calculates new error indicator.
 			double errorIndicator = currentSolution->compute_globalErrorIndicator();
@@ -429,7 +425,7 @@ namespace refinement
 			outputFile.close();
 
 		// Solves solution.
-		currentSolution->Solve(1e-15);
+		currentSolution->Solve(a_solveTolerance);
 
 		// What we're spitting back.
 		*a_meshNew     = currentMesh;
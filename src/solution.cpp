@@ -4,17 +4,26 @@
  * @author     Adam Matthew Blakey
  * @date       2019/12/07
  ******************************************************************************/
+#include "basis.hpp"
 #include "common.hpp"
 #include "element.hpp"
 #include "linearSystems.hpp"
 #include "matrix.hpp"
+#include "matrix_banded.hpp"
 #include "matrix_full.hpp"
 #include "mesh.hpp"
+#include "operator_matrixFree.hpp"
+#include "preconditioner_banded.hpp"
+#include "preconditioner_blockJacobi.hpp"
+#include "preconditioner_incompleteCholesky.hpp"
+#include "preconditioner_jacobi.hpp"
+#include "preconditioner_multigrid.hpp"
 #include "quadrature.hpp"
 #include "solution.hpp"
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cmath>
 #include <fstream>
 #include <iomanip>
@@ -58,13 +67,12 @@ double Solution::compute_norm2(const int &a_n, const bool a_recurse, const int &
 		norm = 0;
 
 	// Retrieves quadrature information.
-	std::vector<double> coordinates;
-	std::vector<double> weights;
-	currentElement->get_elementQuadrature(coordinates, weights);
+	const quadrature::Rule &rule = currentElement->get_elementQuadrature();
+	const double* weights = rule.weights;
 
-	for (int j=0; j<coordinates.size(); ++j)
+	for (int j=0; j<rule.noPoints; ++j)
 	{
-		double uh = compute_uh(a_i, coordinates[j], a_n, a_u);
+		double uh = compute_uhQuadrature(a_i, j, a_n, a_u);
 
 		double Jacobian = currentElement->get_Jacobian();
 		norm += pow(uh, 2)*weights[j]*Jacobian;//pow(Jacobian, 1-a_n);
@@ -90,14 +98,14 @@ double Solution::compute_L2NormDifference2(f_double const &a_u) const
 		Element* currentElement = (*(this->mesh->elements))[i];
 
 		// Retrieves quadrature information.
-		std::vector<double> coordinates;
-		std::vector<double> weights;
-		currentElement->get_elementQuadrature(coordinates, weights);
+		const quadrature::Rule &rule = currentElement->get_elementQuadrature();
+		const double* coordinates = rule.points;
+		const double* weights     = rule.weights;
 
-		for (int j=0; j<coordinates.size(); ++j)
+		for (int j=0; j<rule.noPoints; ++j)
 		{
 			// Actual and approximate solution at coordinates.
-			double uh = compute_uh(i, coordinates[j], 0);
+			double uh = compute_uhQuadrature(i, j, 0);
 			double u =         a_u(currentElement->mapLocalToGlobal(coordinates[j]));
 
 			double Jacobian = currentElement->get_Jacobian();
@@ -124,14 +132,14 @@ double Solution::compute_H1NormDifference2(f_double const &a_u, f_double const &
 		Element* currentElement = (*(this->mesh->elements))[i];
 
 		// Retrieves quadrature information.
-		std::vector<double> coordinates;
-		std::vector<double> weights;
-		currentElement->get_elementQuadrature(coordinates, weights);
+		const quadrature::Rule &rule = currentElement->get_elementQuadrature();
+		const double* coordinates = rule.points;
+		const double* weights     = rule.weights;
 
-		for (int j=0; j<coordinates.size(); ++j)
+		for (int j=0; j<rule.noPoints; ++j)
 		{
 			// Actual and approximate solution at coordinates.
-			double uh_1 = compute_uh(i, coordinates[j], 1);
+			double uh_1 = compute_uhQuadrature(i, j, 1);
 			double u_1  =      a_u_1(currentElement->mapLocalToGlobal(coordinates[j]));
 
 			double Jacobian = currentElement->get_Jacobian();
@@ -145,38 +153,110 @@ double Solution::compute_H1NormDifference2(f_double const &a_u, f_double const &
 }
 
 double Solution::compute_uh(const int &a_i, const double &a_xi, const int &a_n) const
+{
+	return compute_uh(a_i, a_xi, a_n, this->solution);
+}
+
+double Solution::compute_uh(const int &a_i, const double &a_xi, const int &a_n, const std::vector<double> &a_u) const
 {
 	Element* currentElement = (*(this->mesh->elements))[a_i];
 	double J = currentElement->get_Jacobian(); // Needs to be inverse transpose of Jacobi in dimensions higher than 1.
 
+	const int* elementDoFs = this->mesh->elements->get_rawElementDoFs(a_i);
+
+	// Only the nodal shape functions are nonzero at the ends of the
+	//  element, so the values at its nodes are their coefficients.
+	if (a_n == 0 && (a_xi == -1 || a_xi == 1))
+		return a_u[elementDoFs[(a_xi < 0)?0:1]];
+
 	double result = 0;
 
-	std::vector<int> elementDoFs = this->mesh->elements->get_elementDoFs(a_i);
-	for (int j=0; j<elementDoFs.size(); ++j)
+	int noDoFs = this->mesh->elements->get_noElementDoFs(a_i);
+	for (int j=0; j<noDoFs; ++j)
 	{
-		f_double basis = (*(this->mesh->elements))[a_i]->basisFunction(j, a_n);
-
-		result += this->solution[elementDoFs[j]] * basis(a_xi);
+		result += a_u[elementDoFs[j]] * basis::basisFunction(j, a_n, a_xi);
 	}
 
 	return result / pow(J, a_n);
 }
 
-double Solution::compute_uh(const int &a_i, const double &a_xi, const int &a_n, const std::vector<double> &a_u) const
+/******************************************************************************
+ * __compute_uh__
+ * 
+ * @details 	Calculates the nth derivative of the approximate solution at
+ * 				several points of the ith element, evaluating the shape
+ * 				functions at all points in one call.
+ * 
+ * @param[in] a_i 		The element.
+ * @param[in] a_xi 		The points on the reference element.
+ * @param[in] a_n 		Which derivative to calculate.
+ * @return  			The value of the derivative of the solution at each point.
+ ******************************************************************************/
+std::vector<double> Solution::compute_uh(const int &a_i, const std::vector<double> &a_xi, const int &a_n) const
+{
+	return compute_uh(a_i, a_xi, a_n, this->solution);
+}
+
+std::vector<double> Solution::compute_uh(const int &a_i, const std::vector<double> &a_xi, const int &a_n, const std::vector<double> &a_u) const
 {
 	Element* currentElement = (*(this->mesh->elements))[a_i];
 	double J = currentElement->get_Jacobian(); // Needs to be inverse transpose of Jacobi in dimensions higher than 1.
+	int m = a_xi.size();
 
-	double result = 0;
+	std::vector<double> values;
+	currentElement->basisFunctions(a_n, a_xi, values);
+	const double* derivatives = &values[a_n*(currentElement->get_polynomialDegree()+1)*m];
+
+	std::vector<double> result(m, 0);
 
-	std::vector<int> elementDoFs = this->mesh->elements->get_elementDoFs(a_i);
-	for (int j=0; j<elementDoFs.size(); ++j)
+	const int* elementDoFs = this->mesh->elements->get_rawElementDoFs(a_i);
+	int noDoFs = this->mesh->elements->get_noElementDoFs(a_i);
+	for (int j=0; j<noDoFs; ++j)
 	{
-		f_double basis = (*(this->mesh->elements))[a_i]->basisFunction(j, a_n);
+		double u_j = a_u[elementDoFs[j]];
+		const double* row = &derivatives[j*m];
 
-		result += a_u[elementDoFs[j]] * basis(a_xi);
+		for (int k=0; k<m; ++k)
+			result[k] += u_j * row[k];
 	}
 
+	for (int k=0; k<m; ++k)
+		result[k] /= pow(J, a_n);
+
+	return result;
+}
+
+/******************************************************************************
+ * __compute_uhQuadrature__
+ * 
+ * @details 	Calculates the nth derivative of the approximate solution at the
+ * 				kth quadrature point of the ith element, using the tabulated
+ * 				shape functions of that element.
+ * 
+ * @param[in] a_i 		The element.
+ * @param[in] a_k 		The quadrature point given by get_elementQuadrature.
+ * @param[in] a_n 		Which derivative to calculate.
+ * @return  			The value of the derivative of the solution.
+ ******************************************************************************/
+double Solution::compute_uhQuadrature(const int &a_i, const int &a_k, const int &a_n) const
+{
+	return compute_uhQuadrature(a_i, a_k, a_n, this->solution);
+}
+
+double Solution::compute_uhQuadrature(const int &a_i, const int &a_k, const int &a_n, const std::vector<double> &a_u) const
+{
+	Element* currentElement = (*(this->mesh->elements))[a_i];
+	double J = currentElement->get_Jacobian(); // Needs to be inverse transpose of Jacobi in dimensions higher than 1.
+
+	const basis::Tabulation &tabulation = currentElement->get_elementBasis();
+
+	double result = 0;
+
+	const int* elementDoFs = this->mesh->elements->get_rawElementDoFs(a_i);
+	int noDoFs = this->mesh->elements->get_noElementDoFs(a_i);
+	for (int j=0; j<noDoFs; ++j)
+		result += a_u[elementDoFs[j]] * tabulation.get_row(j, a_n)[a_k];
+
 	return result / pow(J, a_n);
 }
 
@@ -192,13 +272,18 @@ void Solution::output_solution(f_double const a_u, const std::string a_filename)
 	{
 		Element* currentElement = (*(this->mesh->elements))[i];
 
+		std::vector<double> xi(10);
+		for (int j=0; j<10; ++j)
+			xi[j] = -1 + j*double(2)/10;
+
+		std::vector<double> uh = this->compute_uh(i, xi, 0);
+
 		for (int j=0; j<10; ++j)
 		{
-			double x  = currentElement->get_nodeCoordinates()[0] + j*((currentElement->get_nodeCoordinates()[1] - currentElement->get_nodeCoordinates()[0])/10);
-			double xi = -1 + j*double(2)/10;
+			double x  = currentElement->get_leftNode() + j*((currentElement->get_rightNode() - currentElement->get_leftNode())/10);
 			outputFile
 				<< std::setw(26) << std::setprecision(16) << std::scientific << x
-				<< std::setw(26) << std::setprecision(16) << std::scientific << this->compute_uh(i, xi, 0);
+				<< std::setw(26) << std::setprecision(16) << std::scientific << uh[j];
 				if (a_u != 0)
 					outputFile << std::setw(26) << std::setprecision(16) << std::scientific << a_u(x);
 				else
@@ -209,10 +294,10 @@ void Solution::output_solution(f_double const a_u, const std::string a_filename)
 
 	Element* lastElement = (*(this->mesh->elements))[n-1];
 	outputFile
-		<< std::setw(26) << std::setprecision(16) << std::scientific << lastElement->get_nodeCoordinates()[1]
-		<< std::setw(26) << std::setprecision(16) << std::scientific << this->solution[n];
+		<< std::setw(26) << std::setprecision(16) << std::scientific << lastElement->get_rightNode()
+		<< std::setw(26) << std::setprecision(16) << std::scientific << this->solution[this->mesh->elements->get_DoFNumber(n)];
 		if (a_u != 0)
-			outputFile << std::setw(26) << std::setprecision(16) << std::scientific << a_u(lastElement->get_nodeCoordinates()[1]);
+			outputFile << std::setw(26) << std::setprecision(16) << std::scientific << a_u(lastElement->get_rightNode());
 		else
 			outputFile << std::setw(26) << std::setprecision(16) << "Inf";
 	outputFile << std::endl;
@@ -233,8 +318,8 @@ void Solution::output_mesh(const std::string a_filename) const
 		Element* currentElement = (*(this->mesh->elements))[i];
 
 		outputFile
-			<< std::setw(26) << std::setprecision(16) << std::scientific << currentElement->get_nodeCoordinates()[0]
-			<< std::setw(26) << std::setprecision(16) << std::scientific << currentElement->get_nodeCoordinates()[1]
+			<< std::setw(26) << std::setprecision(16) << std::scientific << currentElement->get_leftNode()
+			<< std::setw(26) << std::setprecision(16) << std::scientific << currentElement->get_rightNode()
 			<< std::setw(26) << std::setprecision(16) << std::scientific << currentElement->get_polynomialDegree()
 		<< std::endl;
 	}
@@ -266,6 +351,203 @@ std::vector<int> Solution::get_higherOrderDoFs() const
 	return DoFStarts;
 }
 
+/******************************************************************************
+ * __compute_prolongation__
+ * 
+ * @details 	Represents the solution on a mesh made from this one by
+ * 				bisecting elements and raising polynomial degrees, so that
+ * 				every new element lies in an old one with no higher degree.
+ * 				The old solution is then in the new space and is reproduced
+ * 				exactly: the nodal values are its values at the new nodes;
+ * 				the derivatives of the higher-order shape functions are
+ * 				orthogonal Legendre polynomials, to which the vertex
+ * 				functions' constant derivatives are also orthogonal, so each
+ * 				higher-order coefficient is a ratio of two integrals.
+ * 
+ * @param[in] a_mesh 	The new mesh.
+ * @return 				The coefficients on the new mesh, in its numbering.
+ ******************************************************************************/
+std::vector<double> Solution::compute_prolongation(Mesh* const &a_mesh) const
+{
+	Elements* elements = a_mesh->elements;
+	std::vector<double> u(elements->get_DoF(), 0);
+
+	int parentNo = 0;
+	for (int elementNo=0; elementNo<elements->get_noElements(); ++elementNo)
+	{
+		Element* currentElement = (*elements)[elementNo];
+		double left  = currentElement->get_leftNode();
+		double right = currentElement->get_rightNode();
+		double J     = currentElement->get_Jacobian();
+		int    p     = currentElement->get_polynomialDegree();
+
+		// The old element containing this one.
+		while ((*(this->mesh->elements))[parentNo]->get_rightNode() < (left + right)/2)
+			++parentNo;
+		Element* parentElement = (*(this->mesh->elements))[parentNo];
+
+		auto parent_xi = [&](const double &a_x) -> double
+		{
+			double xi = (a_x - parentElement->get_leftNode())/parentElement->get_Jacobian() - 1;
+			return std::min(std::max(xi, -1.0), 1.0);
+		};
+
+		std::vector<int> elementDoFs = elements->get_elementDoFs(elementNo);
+		u[elementDoFs[0]] = this->compute_uh(parentNo, parent_xi(left),  0);
+		u[elementDoFs[1]] = this->compute_uh(parentNo, parent_xi(right), 0);
+
+		if (p < 2)
+			continue;
+
+		// Exact for the products of derivatives, of degree at most 2p-2.
+		const quadrature::Rule &rule = quadrature::get_gaussLegendreRule(p);
+		int m = rule.noPoints;
+
+		std::vector<double> xi(m);
+		for (int k=0; k<m; ++k)
+			xi[k] = parent_xi(currentElement->mapLocalToGlobal(rule.points[k]));
+		std::vector<double> u_x = this->compute_uh(parentNo, xi, 1);
+
+		std::vector<double> values(2*(p+1)*m);
+		basis::basisFunctions(p, 1, m, rule.points, values.data());
+
+		for (int a=2; a<=p; ++a)
+		{
+			const double* phi_a = &values[((p+1) + a)*m];
+
+			double numerator   = 0;
+			double denominator = 0;
+			for (int k=0; k<m; ++k)
+			{
+				numerator   += rule.weights[k]*u_x[k]*J*phi_a[k];
+				denominator += rule.weights[k]*phi_a[k]*phi_a[k];
+			}
+
+			u[elementDoFs[a]] = numerator/denominator;
+		}
+	}
+
+	return u;
+}
+
+/******************************************************************************
+ * __compute_prolongationMatrix__
+ * 
+ * @details 	The matrix P of compute_prolongation, so that P times the
+ * 				coefficients of any function on this mesh gives them on the
+ * 				new one. Each row is found as compute_prolongation finds that
+ * 				DoF, with the old shape functions in place of the solution;
+ * 				a node shared by two new elements is taken from the first.
+ * 				With P^T, this is how multigrid moves between the meshes of
+ * 				a refinement hierarchy.
+ * 
+ * @param[in] a_mesh 	The new mesh.
+ * @return 				P, with rows in the new numbering and columns in this
+ * 						 mesh's.
+ ******************************************************************************/
+Matrix_sparse<double> Solution::compute_prolongationMatrix(Mesh* const &a_mesh) const
+{
+	Elements* elements    = a_mesh->elements;
+	Elements* oldElements = this->mesh->elements;
+
+	std::vector<int>    xs;
+	std::vector<int>    ys;
+	std::vector<double> values;
+	std::vector<bool>   found(elements->get_DoF(), false);
+
+	auto add_entry = [&](const int &a_row, const int &a_column, const double &a_value)
+	{
+		if (a_value == 0)
+			return;
+
+		xs    .push_back(a_column);
+		ys    .push_back(a_row);
+		values.push_back(a_value);
+	};
+
+	int parentNo = 0;
+	for (int elementNo=0; elementNo<elements->get_noElements(); ++elementNo)
+	{
+		Element* currentElement = (*elements)[elementNo];
+		double left  = currentElement->get_leftNode();
+		double right = currentElement->get_rightNode();
+		double J     = currentElement->get_Jacobian();
+		int    p     = currentElement->get_polynomialDegree();
+
+		// The old element containing this one.
+		while ((*oldElements)[parentNo]->get_rightNode() < (left + right)/2)
+			++parentNo;
+		Element* parentElement = (*oldElements)[parentNo];
+		double   parentJ       = parentElement->get_Jacobian();
+		int      parentP       = parentElement->get_polynomialDegree();
+
+		auto parent_xi = [&](const double &a_x) -> double
+		{
+			double xi = (a_x - parentElement->get_leftNode())/parentJ - 1;
+			return std::min(std::max(xi, -1.0), 1.0);
+		};
+
+		std::vector<int> elementDoFs = elements   ->get_elementDoFs(elementNo);
+		std::vector<int> parentDoFs  = oldElements->get_elementDoFs(parentNo);
+
+		// The nodes take the values of the old shape functions there.
+		double nodes[2] = {parent_xi(left), parent_xi(right)};
+		std::vector<double> nodeValues(2*(parentP+1));
+		basis::basisFunctions(parentP, 0, 2, nodes, nodeValues.data());
+
+		for (int k=0; k<2; ++k)
+		{
+			if (found[elementDoFs[k]])
+				continue;
+			found[elementDoFs[k]] = true;
+
+			for (int b=0; b<=parentP; ++b)
+				add_entry(elementDoFs[k], parentDoFs[b], nodeValues[b*2 + k]);
+		}
+
+		if (p < 2)
+			continue;
+
+		const quadrature::Rule &rule = quadrature::get_gaussLegendreRule(p);
+		int m = rule.noPoints;
+
+		std::vector<double> xi(m);
+		for (int k=0; k<m; ++k)
+			xi[k] = parent_xi(currentElement->mapLocalToGlobal(rule.points[k]));
+
+		std::vector<double> parentValues(2*(parentP+1)*m);
+		basis::basisFunctions(parentP, 1, m, xi.data(), parentValues.data());
+
+		std::vector<double> elementValues(2*(p+1)*m);
+		basis::basisFunctions(p, 1, m, rule.points, elementValues.data());
+
+		for (int a=2; a<=p; ++a)
+		{
+			const double* phi_a = &elementValues[((p+1) + a)*m];
+
+			double denominator = 0;
+			for (int k=0; k<m; ++k)
+				denominator += rule.weights[k]*phi_a[k]*phi_a[k];
+
+			for (int b=0; b<=parentP; ++b)
+			{
+				const double* psi_b = &parentValues[((parentP+1) + b)*m];
+
+				double numerator = 0;
+				for (int k=0; k<m; ++k)
+					numerator += rule.weights[k]*psi_b[k]/parentJ*J*phi_a[k];
+
+				add_entry(elementDoFs[a], parentDoFs[b], numerator/denominator);
+			}
+		}
+	}
+
+	Matrix_sparse<double> prolongation(elements->get_DoF(), oldElements->get_DoF(), xs, ys);
+	prolongation.set_values(values);
+
+	return prolongation;
+}
+
 std::vector<double> Solution::compute_errorIndicators() const
 {
 	std::vector<double> errorIndicators(this->noElements);
@@ -280,8 +562,8 @@ double Solution::compute_smoothnessIndicator(const int &a_i) const
 {
 	Element* currentElement = (*(this->mesh->elements))[a_i];
 	double Jacobian  = currentElement->get_Jacobian();
-	double leftNode  = currentElement->get_nodeCoordinates()[0];
-	double rightNode = currentElement->get_nodeCoordinates()[1];
+	double leftNode  = currentElement->get_leftNode();
+	double rightNode = currentElement->get_rightNode();
 	double h = rightNode - leftNode;
 
 	int noTestPoints = 10;
@@ -289,11 +571,9 @@ double Solution::compute_smoothnessIndicator(const int &a_i) const
 	for (int i=0; i<noTestPoints; ++i)
 		testPoints[i] = -1 + i*double(2)/(noTestPoints-1);
 
-	std::vector<double> testValuesAbs(noTestPoints);
+	std::vector<double> testValuesAbs = compute_uh(a_i, testPoints, 0);
 	for (int i=0; i<noTestPoints; ++i)
-	{
-		testValuesAbs[i] = fabs(compute_uh(a_i, testPoints[i], 0));
-	}
+		testValuesAbs[i] = fabs(testValuesAbs[i]);
 
 	double u_max = *max_element(testValuesAbs.begin(), testValuesAbs.end());
 
@@ -317,4 +597,758 @@ std::vector<double> Solution::compute_smoothnessIndicators() const
 bool Solution::get_linear() const
 {
 	return this->linear;
+}
+
+linearSystems::Preconditioning Solution::get_preconditioning() const
+{
+	return this->preconditioning;
+}
+
+bool Solution::get_directSolver() const
+{
+	return this->directSolver;
+}
+
+bool Solution::get_mixedPrecision() const
+{
+	return this->mixedPrecision;
+}
+
+bool Solution::get_staticCondensation() const
+{
+	return this->staticCondensation;
+}
+
+linearSystems::Cycle Solution::get_multigridCycle() const
+{
+	return this->multigridCycle;
+}
+
+bool Solution::get_multigridSolver() const
+{
+	return this->multigridSolver;
+}
+
+/******************************************************************************
+ * __get_noMultigridLevels__
+ * 
+ * @details 	The number of levels a multigrid cycle would use, counting
+ * 				this mesh.
+ ******************************************************************************/
+int Solution::get_noMultigridLevels() const
+{
+	return this->prolongations.size() + 1;
+}
+
+const boundaryConditions::Condition& Solution::get_boundaryCondition(const boundaryConditions::Side &a_side) const
+{
+	return this->boundaryConditions[a_side];
+}
+
+const linearSystems::StoppingCriteria& Solution::get_stoppingCriteria() const
+{
+	return this->stoppingCriteria;
+}
+
+double Solution::get_adaptiveFraction() const
+{
+	return this->adaptiveFraction;
+}
+
+const std::vector<double>& Solution::get_initialGuess() const
+{
+	return this->initialGuess;
+}
+
+/******************************************************************************
+ * __get_solverStatistics__
+ * 
+ * @details 	What the linear solves of the last Solve cost; summed over the
+ * 				iterations of a nonlinear solve.
+ ******************************************************************************/
+const linearSystems::Statistics& Solution::get_solverStatistics() const
+{
+	return this->solverStatistics;
+}
+
+/******************************************************************************
+ * __set_preconditioning__
+ * 
+ * @details 	Chooses the preconditioner for CG. Block Jacobi uses one block
+ * 				per element, from Elements::get_elementBlocks, which overlap
+ * 				at the nodes. Multigrid uses the meshes refinement made this
+ * 				one from, which are only kept if it was chosen before
+ * 				refining; without them its cycle is a direct solve.
+ * 				Matrix-free solves only have the diagonal, so use Jacobi for
+ * 				any choice other than None.
+ * 
+ * @param[in] a_preconditioning 	The preconditioner.
+ ******************************************************************************/
+void Solution::set_preconditioning(const linearSystems::Preconditioning &a_preconditioning)
+{
+	this->preconditioning = a_preconditioning;
+}
+
+/******************************************************************************
+ * __set_directSolver__
+ * 
+ * @details 	Chooses whether assembled systems are solved by a banded LDL^T
+ * 				factorisation instead of CG. The cost grows with the square
+ * 				of the bandwidth, so a numbering with a wider band than the
+ * 				elements', such as NodesFirst, is renumbered element by element
+ * 				for the factorisation. Matrix-free solves always use CG.
+ * 
+ * @param[in] a_directSolver 	Whether to solve directly.
+ ******************************************************************************/
+void Solution::set_directSolver(const bool &a_directSolver)
+{
+	this->directSolver = a_directSolver;
+}
+
+/******************************************************************************
+ * __set_mixedPrecision__
+ * 
+ * @details 	Chooses whether the direct solver factorises in float, which
+ * 				halves the memory the factors take and the traffic of each
+ * 				solve with them, and then refines the solution in double; see
+ * 				linearSystems::iterativeRefinement. If the matrix is too ill
+ * 				conditioned for refinement to reach the tolerance, CG
+ * 				preconditioned by the float factors finishes the solve.
+ * 
+ * @param[in] a_mixedPrecision 	Whether to factorise in float.
+ ******************************************************************************/
+void Solution::set_mixedPrecision(const bool &a_mixedPrecision)
+{
+	this->mixedPrecision = a_mixedPrecision;
+}
+
+/******************************************************************************
+ * __set_staticCondensation__
+ * 
+ * @details 	Chooses whether assembled systems are solved by eliminating
+ * 				the higher-order DoFs element by element, which leaves a
+ * 				tridiagonal system for the nodes. This takes precedence over
+ * 				set_directSolver and the preconditioner; matrix-free solves
+ * 				always use CG.
+ * 
+ * @param[in] a_staticCondensation 	Whether to condense.
+ ******************************************************************************/
+void Solution::set_staticCondensation(const bool &a_staticCondensation)
+{
+	this->staticCondensation = a_staticCondensation;
+}
+
+/******************************************************************************
+ * __set_multigridCycle__
+ * 
+ * @details 	Chooses the cycle of the Multigrid preconditioner. A W-cycle
+ * 				visits each coarser level twice as often, which costs more
+ * 				but converges faster on meshes graded far from uniform.
+ * 
+ * @param[in] a_multigridCycle 	The cycle.
+ ******************************************************************************/
+void Solution::set_multigridCycle(const linearSystems::Cycle &a_multigridCycle)
+{
+	this->multigridCycle = a_multigridCycle;
+}
+
+/******************************************************************************
+ * __set_multigridSolver__
+ * 
+ * @details 	Chooses whether the Multigrid preconditioner is used as the
+ * 				solver itself, repeating cycles on the residual, rather than
+ * 				inside CG. CG takes over if the cycles stop converging
+ * 				quickly; see solve_refined.
+ * 
+ * @param[in] a_multigridSolver 	Whether to solve by multigrid cycles.
+ ******************************************************************************/
+void Solution::set_multigridSolver(const bool &a_multigridSolver)
+{
+	this->multigridSolver = a_multigridSolver;
+}
+
+/******************************************************************************
+ * __set_multigridLevels__
+ * 
+ * @details 	Keeps the levels of a solution on the mesh this one's was
+ * 				refined from, and that mesh as a new level, if Multigrid is
+ * 				the preconditioner. Levels with little more than the DoFs of
+ * 				the one below, as local refinement makes, would make cycles
+ * 				cost more than O(DoF), so if the level below the old mesh
+ * 				has over 2/3 of its DoFs, the old mesh is dropped and the
+ * 				new one prolonged straight from that level. Cycles then visit
+ * 				at most about four times the DoFs of this mesh.
+ * 
+ * @param[in] a_solution 	The solution on the old mesh.
+ ******************************************************************************/
+void Solution::set_multigridLevels(const Solution* const &a_solution)
+{
+	this->prolongations.clear();
+	if (this->preconditioning != linearSystems::Multigrid)
+		return;
+
+	for (const Matrix_sparse<double> &prolongation : a_solution->prolongations)
+		this->prolongations.push_back(prolongation);
+
+	Matrix_sparse<double> prolongation = a_solution->compute_prolongationMatrix(this->mesh);
+
+	if (!this->prolongations.empty() && 3*this->prolongations.back().get_noColumns() > 2*this->prolongations.back().get_noRows())
+	{
+		Matrix_sparse<double> composition = prolongation.get_product(this->prolongations.back());
+		this->prolongations.pop_back();
+		this->prolongations.push_back(composition);
+	}
+	else
+		this->prolongations.push_back(prolongation);
+}
+
+/******************************************************************************
+ * __set_boundaryCondition__
+ * 
+ * @details 	Sets the condition at one end of the domain; both start as
+ * 				u = 0.
+ * 
+ * @param[in] a_side 		The end.
+ * @param[in] a_condition 	The condition there.
+ ******************************************************************************/
+void Solution::set_boundaryCondition(const boundaryConditions::Side &a_side, const boundaryConditions::Condition &a_condition)
+{
+	this->boundaryConditions[a_side] = a_condition;
+}
+
+/******************************************************************************
+ * __set_stoppingCriteria__
+ * 
+ * @details 	Chooses when CG stops. The absolute tolerance is always the one
+ * 				given to Solve, and the energy tolerance is set by
+ * 				set_adaptiveFraction; the other rules are taken from here.
+ * 
+ * @param[in] a_stoppingCriteria 	The rules.
+ ******************************************************************************/
+void Solution::set_stoppingCriteria(const linearSystems::StoppingCriteria &a_stoppingCriteria)
+{
+	this->stoppingCriteria = a_stoppingCriteria;
+}
+
+/******************************************************************************
+ * __set_adaptiveFraction__
+ * 
+ * @details 	Makes linear solves stop once the estimated energy norm of the
+ * 				algebraic error is at most this fraction of the global error
+ * 				indicator, since solving further cannot make the solution
+ * 				more accurate than the mesh allows. Zero, the default, solves
+ * 				to the tolerance given to Solve. Not used by nonlinear solves.
+ * 
+ * @param[in] a_adaptiveFraction 	The fraction, e.g. 0.1.
+ ******************************************************************************/
+void Solution::set_adaptiveFraction(const double &a_adaptiveFraction)
+{
+	this->adaptiveFraction = a_adaptiveFraction;
+}
+
+/******************************************************************************
+ * __set_initialGuess__
+ * 
+ * @details 	Sets where the iterative solvers start from. A solution made
+ * 				by refining another starts from that one's solution prolonged
+ * 				to the new mesh; an empty guess clears this, so that they
+ * 				start from zero, e.g. to time cold solves.
+ * 
+ * @param[in] a_initialGuess 	The coefficients on this mesh, or empty.
+ ******************************************************************************/
+void Solution::set_initialGuess(const std::vector<double> &a_initialGuess)
+{
+	assert(a_initialGuess.empty() || a_initialGuess.size() == this->mesh->elements->get_DoF());
+
+	this->initialGuess = a_initialGuess;
+}
+
+/******************************************************************************
+ * __solve_linearSystem__
+ * 
+ * @details 	Builds the chosen preconditioner and runs PCG, or repeats
+ * 				multigrid cycles if set_multigridSolver was asked to, or
+ * 				factorises and solves directly if set_directSolver was; then
+ * 				the setup time is that of the factorisation, and there are
+ * 				no iterations, unless the factorisation is in float and the
+ * 				iterations are the steps refining it.
+ * 
+ * @param[in] a_matrix 			The matrix.
+ * @param[in] a_b 				The right-hand side.
+ * @param[in] a_x0 				Where CG starts from, or empty for zero.
+ * @param[in] a_tolerance 		The largest 2-norm of the residual allowed.
+ * @param[out] a_statistics 	What the solve cost.
+ * @param[in] a_energyTolerance The largest estimated energy norm of the
+ * 								 error allowed, or zero for no limit.
+ * @return 						The solution.
+ ******************************************************************************/
+std::vector<double> Solution::solve_linearSystem(const Matrix_sparse<double> &a_matrix, const std::vector<double> &a_b, const std::vector<double> &a_x0, const double &a_tolerance, linearSystems::Statistics &a_statistics, const double &a_energyTolerance) const
+{
+	auto start = std::chrono::steady_clock::now();
+
+	linearSystems::StoppingCriteria criteria = this->stoppingCriteria;
+	criteria.absoluteTolerance = a_tolerance;
+	criteria.energyTolerance   = a_energyTolerance;
+
+	// The band of a numbering such as NodesFirst spans most of the matrix,
+	//  so it is factorised in an element by element numbering instead.
+	std::vector<int> numbering;
+	if (this->directSolver)
+		numbering = this->compute_bandedNumbering(a_matrix);
+	if (!numbering.empty())
+	{
+		int n = a_matrix.get_noRows();
+		Matrix_sparse<double> renumberedMatrix = a_matrix.get_permuted(numbering);
+
+		std::vector<double> b(n);
+		std::vector<double> x0(a_x0.size());
+		for (int i=0; i<n; ++i)
+			b[numbering[i]] = a_b[i];
+		for (int i=0; i<a_x0.size(); ++i)
+			x0[numbering[i]] = a_x0[i];
+
+		double renumberingTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::vector<double> renumberedX = this->solve_linearSystem(renumberedMatrix, b, x0, a_tolerance, a_statistics, a_energyTolerance);
+		a_statistics.setupTime += renumberingTime;
+
+		std::vector<double> x(n);
+		for (int i=0; i<n; ++i)
+			x[i] = renumberedX[numbering[i]];
+
+		return x;
+	}
+
+	if (this->directSolver && this->mixedPrecision)
+	{
+		Preconditioner_banded factors(a_matrix);
+
+		a_statistics.setupTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		return this->solve_refined(a_matrix, &factors, a_b, a_x0, criteria, a_statistics);
+	}
+
+	if (this->directSolver)
+	{
+		Matrix_banded<double> bandedMatrix(a_matrix);
+		bandedMatrix.factorise();
+
+		auto factorised = std::chrono::steady_clock::now();
+
+		std::vector<double> x = bandedMatrix.solve(a_b);
+
+		std::vector<double> residual = a_matrix*x;
+		for (int i=0; i<residual.size(); ++i)
+			residual[i] -= a_b[i];
+
+		a_statistics.noIterations   = 0;
+		a_statistics.residualNorm   = sqrt(linearSystems::dotProduct(residual, residual));
+		a_statistics.stoppingReason = linearSystems::Converged;
+		a_statistics.errorEstimate  = NAN;
+		a_statistics.setupTime      = std::chrono::duration<double>(factorised - start).count();
+		a_statistics.solveTime      = std::chrono::duration<double>(std::chrono::steady_clock::now() - factorised).count();
+
+		return x;
+	}
+
+	Preconditioner* preconditioner = 0;
+	switch (this->preconditioning)
+	{
+		case linearSystems::Jacobi:
+			preconditioner = new Preconditioner_jacobi(a_matrix.get_diagonal());
+			break;
+
+		case linearSystems::BlockJacobi:
+		{
+			std::vector<int> blockStarts;
+			std::vector<int> blockDoFs;
+			this->mesh->elements->get_elementBlocks(blockStarts, blockDoFs);
+
+			preconditioner = new Preconditioner_blockJacobi(a_matrix, blockStarts, blockDoFs);
+			break;
+		}
+
+		case linearSystems::IncompleteCholesky:
+			preconditioner = new Preconditioner_incompleteCholesky(a_matrix);
+			break;
+
+		case linearSystems::Multigrid:
+			preconditioner = new Preconditioner_multigrid(a_matrix, this->prolongations, this->multigridCycle);
+			break;
+
+		default:
+			break;
+	}
+
+	a_statistics.setupTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::vector<double> x;
+	if (this->preconditioning == linearSystems::Multigrid && this->multigridSolver)
+		x = this->solve_refined(a_matrix, preconditioner, a_b, a_x0, criteria, a_statistics);
+	else
+		x = linearSystems::preconditionedConjugateGradient(a_matrix, preconditioner, a_b, a_x0, criteria, this->workspace, a_statistics);
+
+	delete preconditioner;
+
+	return x;
+}
+
+/******************************************************************************
+ * __compute_bandedNumbering__
+ * 
+ * @details 	Numbers the DoFs element by element: the left node, the
+ * 				higher-order DoFs, then the right node, skipping DoFs already
+ * 				numbered. This is the Interleaved numbering, whose half-
+ * 				bandwidth is the largest polynomial degree, whatever the
+ * 				mesh's numbering is.
+ * 
+ * @param[in] a_matrix 	A global matrix of the mesh.
+ * @return 				The new number of each DoF, or nothing if the
+ * 						 matrix's band is no wider already.
+ ******************************************************************************/
+std::vector<int> Solution::compute_bandedNumbering(const Matrix_sparse<double> &a_matrix) const
+{
+	const Elements* elements = this->mesh->elements;
+	int n = a_matrix.get_noRows();
+
+	if (n != elements->get_DoF())
+		return std::vector<int>();
+
+	const std::vector<int> &rowStarts = a_matrix.get_rowStarts();
+	const std::vector<int> &columnNos = a_matrix.get_columnNos();
+
+	int bandwidth = 0;
+	for (int j=0; j<n; ++j)
+		for (int index=rowStarts[j]; index<rowStarts[j+1]; ++index)
+			bandwidth = std::max(bandwidth, columnNos[index]-j);
+
+	int elementBandwidth = 0;
+	for (int elementNo=0; elementNo<this->mesh->get_noElements(); ++elementNo)
+		elementBandwidth = std::max(elementBandwidth, elements->get_noElementDoFs(elementNo)-1);
+
+	if (bandwidth <= elementBandwidth)
+		return std::vector<int>();
+
+	std::vector<int> numbering(n, -1);
+	int DoFNo = 0;
+	for (int elementNo=0; elementNo<this->mesh->get_noElements(); ++elementNo)
+	{
+		const int* elementDoFs = elements->get_rawElementDoFs(elementNo);
+		int noDoFs = elements->get_noElementDoFs(elementNo);
+
+		for (int a=0; a<noDoFs; ++a)
+		{
+			int DoF = elementDoFs[(a == 0)?0:(a == noDoFs-1)?1:a+1];
+			if (numbering[DoF] == -1)
+				numbering[DoF] = DoFNo++;
+		}
+	}
+
+	return numbering;
+}
+
+/******************************************************************************
+ * __solve_refined__
+ * 
+ * @details 	Repeats x += M^{-1}(b - Ax) for an approximate solver M, e.g. a
+ * 				float factorisation or a multigrid cycle, and if that stops
+ * 				gaining carries on from x with CG preconditioned by M. The
+ * 				statistics count the steps of both, but not the setup time,
+ * 				which is left alone.
+ * 
+ * @param[in] a_matrix 			The matrix.
+ * @param[in] a_solver 			M.
+ * @param[in] a_b 				The right-hand side.
+ * @param[in] a_x0 				Where to start from, or empty for zero.
+ * @param[in] a_criteria 		When to stop.
+ * @param[out] a_statistics 	What the solve cost.
+ * @return 						The solution.
+ ******************************************************************************/
+std::vector<double> Solution::solve_refined(const Matrix_sparse<double> &a_matrix, const Preconditioner* const &a_solver, const std::vector<double> &a_b, const std::vector<double> &a_x0, const linearSystems::StoppingCriteria &a_criteria, linearSystems::Statistics &a_statistics) const
+{
+	std::vector<double> x = linearSystems::iterativeRefinement(a_matrix, a_solver, a_b, a_x0, a_criteria, this->workspace, a_statistics);
+	if (a_statistics.stoppingReason != linearSystems::Stagnated)
+		return x;
+
+	int    noSteps   = a_statistics.noIterations;
+	double stepsTime = a_statistics.solveTime;
+
+	x = linearSystems::preconditionedConjugateGradient(a_matrix, a_solver, a_b, x, a_criteria, this->workspace, a_statistics);
+	a_statistics.noIterations += noSteps;
+	a_statistics.solveTime    += stepsTime;
+
+	return x;
+}
+
+std::vector<double> Solution::solve_linearSystem(const Operator_matrixFree &a_operator, const std::vector<double> &a_b, const std::vector<double> &a_x0, const double &a_tolerance, linearSystems::Statistics &a_statistics, const double &a_energyTolerance) const
+{
+	auto start = std::chrono::steady_clock::now();
+
+	Preconditioner* preconditioner = 0;
+	if (this->preconditioning != linearSystems::None)
+		preconditioner = new Preconditioner_jacobi(a_operator.get_diagonal());
+
+	a_statistics.setupTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	linearSystems::StoppingCriteria criteria = this->stoppingCriteria;
+	criteria.absoluteTolerance = a_tolerance;
+	criteria.energyTolerance   = a_energyTolerance;
+
+	std::vector<double> x = linearSystems::preconditionedConjugateGradient(a_operator, preconditioner, a_b, a_x0, criteria, this->workspace, a_statistics);
+
+	delete preconditioner;
+
+	return x;
+}
+
+/******************************************************************************
+ * __solve_adaptively__
+ * 
+ * @details 	Runs a linear solve and puts the result in the solution. If an
+ * 				adaptive fraction is set, the solve only goes until the
+ * 				estimated algebraic error is that fraction of the global
+ * 				error indicator. The indicator is first taken of the initial
+ * 				guess, or zero, and taken again after each solve; while the
+ * 				solve stopped short of the new target it is resumed from
+ * 				where it got to. The statistics are summed over the solves.
+ * 
+ * @param[in] a_solve 	Solves from a given start to a given energy
+ * 						 tolerance, filling in the solver statistics.
+ ******************************************************************************/
+void Solution::solve_adaptively(const std::function<std::vector<double>(const std::vector<double>&, const double&)> &a_solve)
+{
+	if (this->adaptiveFraction <= 0)
+	{
+		this->solution = a_solve(this->initialGuess, 0);
+		return;
+	}
+
+	this->solution = this->initialGuess;
+	if (this->solution.empty())
+		this->solution.assign(this->mesh->elements->get_DoF(), 0);
+
+	double errorIndicator = this->compute_globalErrorIndicator();
+	linearSystems::Statistics statistics = {0, 0, 0, 0, linearSystems::Converged, 0};
+
+	int maxNoSolves = 10;
+	for (int solveNo=0; solveNo<maxNoSolves; ++solveNo)
+	{
+		this->solution = a_solve(this->solution, this->adaptiveFraction*errorIndicator);
+		errorIndicator = this->compute_globalErrorIndicator();
+
+		statistics.noIterations  += this->solverStatistics.noIterations;
+		statistics.residualNorm   = this->solverStatistics.residualNorm;
+		statistics.setupTime     += this->solverStatistics.setupTime;
+		statistics.solveTime     += this->solverStatistics.solveTime;
+		statistics.stoppingReason = this->solverStatistics.stoppingReason;
+		statistics.errorEstimate  = this->solverStatistics.errorEstimate;
+
+		// No estimate (NaN) means the residual tolerance was met first.
+		if (statistics.stoppingReason != linearSystems::Converged || !(statistics.errorEstimate > this->adaptiveFraction*errorIndicator))
+			break;
+	}
+
+	this->solverStatistics = statistics;
+}
+
+/******************************************************************************
+ * __apply_boundaryConditions__
+ * 
+ * @details 	Applies the boundary conditions to an element's contributions
+ * 				as they are scattered; only the end elements have any. See
+ * 				boundaryConditions::apply.
+ * 
+ * @param[in] a_elementNo 		The element.
+ * @param[in] a_elementDoFs 	Its DoFs.
+ * @param[in,out] a_K 			Its matrix, with entry (a, b) at a*N + b.
+ * @param[in,out] a_b 			The global right-hand side.
+ * @param[in] a_u 				The Newton iterate, if the system is for a
+ * 								 Newton update.
+ ******************************************************************************/
+void Solution::apply_boundaryConditions(const int &a_elementNo, const std::vector<int> &a_elementDoFs, double a_K[], std::vector<double> &a_b, const std::vector<double> &a_u) const
+{
+	// The left node is the element's first DoF and the right its second.
+	if (a_elementNo == 0)
+		boundaryConditions::apply(this->boundaryConditions[boundaryConditions::Left], 0, a_elementDoFs, a_K, a_b, a_u);
+	if (a_elementNo == this->noElements-1)
+		boundaryConditions::apply(this->boundaryConditions[boundaryConditions::Right], 1, a_elementDoFs, a_K, a_b, a_u);
+}
+
+/******************************************************************************
+ * __apply_boundaryConditions__
+ * 
+ * @details 	Gives a matrix-free operator its Dirichlet DoFs and the
+ * 				diagonal terms of Robin conditions; the right-hand side is
+ * 				dealt with by the version above.
+ ******************************************************************************/
+void Solution::apply_boundaryConditions(Operator_matrixFree &a_operator) const
+{
+	std::vector<int>    dirichletDoFs;
+	std::vector<int>    robinDoFs;
+	std::vector<double> robinCoefficients;
+
+	for (int side=0; side<2; ++side)
+	{
+		const boundaryConditions::Condition &condition = this->boundaryConditions[side];
+		int DoF = this->mesh->elements->get_DoFNumber((side == boundaryConditions::Left)?0:this->noElements);
+
+		if (condition.type == boundaryConditions::Dirichlet)
+			dirichletDoFs.push_back(DoF);
+		else if (condition.type == boundaryConditions::Robin)
+		{
+			robinDoFs.push_back(DoF);
+			robinCoefficients.push_back(condition.coefficient);
+		}
+	}
+
+	a_operator.set_dirichletDoFs(dirichletDoFs);
+	a_operator.set_boundaryCoefficients(robinDoFs, robinCoefficients);
+}
+
+/******************************************************************************
+ * __apply_dirichletValues__
+ * 
+ * @details 	Sets the Dirichlet DoFs of a vector to their values exactly,
+ * 				whatever tolerance they were solved to.
+ ******************************************************************************/
+void Solution::apply_dirichletValues(std::vector<double> &a_u) const
+{
+	for (int side=0; side<2; ++side)
+		if (this->boundaryConditions[side].type == boundaryConditions::Dirichlet)
+			a_u[this->mesh->elements->get_DoFNumber((side == boundaryConditions::Left)?0:this->noElements)] = this->boundaryConditions[side].value;
+}
+
+/******************************************************************************
+ * __solve_condensed__
+ * 
+ * @details 	Solves the global system by static condensation. The
+ * 				higher-order DoFs of an element only couple to that element,
+ * 				so each element eliminates its own with a factorisation of
+ * 				its bubble block; the Schur complements on the nodes make a
+ * 				tridiagonal system, solved by linearSystems::thomasInvert.
+ * 				Each element then recovers its higher-order values from its
+ * 				nodal ones. The work is O(N p^3) in the eliminations, which
+ * 				are independent of each other, and O(N) in the global solve.
+ * 				The setup time is that of the eliminations.
+ * 
+ * @param[in] a_stiffnessValues 	The element matrices, in the order of
+ * 									 Elements::get_assemblyPattern, with
+ * 									 the boundary conditions applied.
+ * @param[in] a_b 					The assembled right-hand side.
+ * @param[out] a_statistics 		What the solve cost.
+ * @return 							The solution.
+ ******************************************************************************/
+std::vector<double> Solution::solve_condensed(const std::vector<double> &a_stiffnessValues, const std::vector<double> &a_b, linearSystems::Statistics &a_statistics) const
+{
+	auto start = std::chrono::steady_clock::now();
+
+	Elements* elements = this->mesh->elements;
+	int m = this->noElements;
+
+	// The tridiagonal Schur complement and its right-hand side, by node.
+	std::vector<double> lower(m, 0);
+	std::vector<double> diagonal(m+1, 0);
+	std::vector<double> upper(m, 0);
+	std::vector<double> d(m+1, 0);
+
+	for (int i=0; i<=m; ++i)
+		d[i] = a_b[elements->get_DoFNumber(i)];
+
+	// K_bb^-1 K_bv and K_bb^-1 f_b for each element, kept for the recovery.
+	std::vector<double> eliminated;
+	std::vector<int>    eliminatedStarts(m+1, 0);
+
+	int valuesStart = 0;
+	for (int elementNo=0; elementNo<m; ++elementNo)
+	{
+		std::vector<int> DoFs = elements->get_elementDoFs(elementNo);
+		int N  = DoFs.size();
+		int nb = N - 2;
+		const double* K = a_stiffnessValues.data() + valuesStart;
+		valuesStart += N*N;
+
+		double S[2][2] = {{K[0], K[1]}, {K[N], K[N+1]}};
+
+		eliminatedStarts[elementNo+1] = eliminatedStarts[elementNo] + 3*nb;
+
+		if (nb > 0)
+		{
+			Matrix_banded<double> bubbleMatrix(nb, nb-1);
+			for (int i=0; i<nb; ++i)
+				for (int j=i; j<nb; ++j)
+					bubbleMatrix.set(j, i, K[(2+i)*N + 2+j]);
+			bubbleMatrix.factorise();
+
+			std::vector<double> rhs(nb);
+			std::vector<double> x;
+			for (int c=0; c<3; ++c)
+			{
+				for (int i=0; i<nb; ++i)
+					rhs[i] = (c < 2)?K[(2+i)*N + c]:a_b[DoFs[2+i]];
+
+				bubbleMatrix.solve(rhs, x);
+				eliminated.insert(eliminated.end(), x.begin(), x.end());
+			}
+
+			const double* X = eliminated.data() + eliminatedStarts[elementNo];
+			for (int r=0; r<2; ++r)
+			{
+				for (int i=0; i<nb; ++i)
+				{
+					double K_rb = K[r*N + 2+i];
+
+					S[r][0] -= K_rb*X[i];
+					S[r][1] -= K_rb*X[nb + i];
+					d[elementNo+r] -= K_rb*X[2*nb + i];
+				}
+			}
+		}
+
+		diagonal[elementNo]   += S[0][0];
+		upper   [elementNo]   += S[0][1];
+		lower   [elementNo]   += S[1][0];
+		diagonal[elementNo+1] += S[1][1];
+	}
+
+	auto eliminatedTime = std::chrono::steady_clock::now();
+
+	std::vector<double> nodalValues(m+1);
+	linearSystems::thomasInvert(lower, diagonal, upper, d, nodalValues);
+
+	// Recovers the higher-order DoFs.
+	std::vector<double> x(a_b.size(), 0);
+	for (int elementNo=0; elementNo<m; ++elementNo)
+	{
+		std::vector<int> DoFs = elements->get_elementDoFs(elementNo);
+		int nb = DoFs.size() - 2;
+		const double* X = eliminated.data() + eliminatedStarts[elementNo];
+
+		x[DoFs[0]] = nodalValues[elementNo];
+		x[DoFs[1]] = nodalValues[elementNo+1];
+
+		for (int i=0; i<nb; ++i)
+			x[DoFs[2+i]] = X[2*nb + i] - X[i]*nodalValues[elementNo] - X[nb + i]*nodalValues[elementNo+1];
+	}
+
+	a_statistics.setupTime = std::chrono::duration<double>(eliminatedTime - start).count();
+	a_statistics.solveTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - eliminatedTime).count();
+
+	// The residual of the full system, element by element.
+	std::vector<double> residual = a_b;
+	valuesStart = 0;
+	for (int elementNo=0; elementNo<m; ++elementNo)
+	{
+		std::vector<int> DoFs = elements->get_elementDoFs(elementNo);
+		int N = DoFs.size();
+
+		for (int a=0; a<N; ++a)
+			for (int b=0; b<N; ++b)
+				residual[DoFs[a]] -= a_stiffnessValues[valuesStart + a*N + b]*x[DoFs[b]];
+
+		valuesStart += N*N;
+	}
+	a_statistics.noIterations = 0;
+	a_statistics.residualNorm = sqrt(linearSystems::dotProduct(residual, residual));
+
+	return x;
 }
\ No newline at end of file
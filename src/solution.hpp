@@ -7,29 +7,74 @@
 #ifndef CLASS_SOLUTION
 #define CLASS_SOLUTION
 
+#include "boundaryConditions.hpp"
 #include "common.hpp"
+#include "linearSystems.hpp"
+#include <functional>
 #include <vector>
 
+class Operator_matrixFree;
+
 class Solution
 {
 	protected:
 		// Data.
 		int noElements;
 		std::vector<double> solution;
-		std::vector<double> boundaryConditions;
+		std::vector<boundaryConditions::Condition> boundaryConditions; // Left and right.
 		Mesh* mesh;
 		bool linear;
 
+		// Linear solver.
+		linearSystems::Preconditioning preconditioning = linearSystems::None;
+		bool directSolver = false;
+		bool mixedPrecision = false;
+		bool staticCondensation = false;
+		linearSystems::Cycle multigridCycle = linearSystems::VCycle;
+		bool multigridSolver = false;
+		linearSystems::StoppingCriteria stoppingCriteria;
+		double adaptiveFraction = 0;
+		linearSystems::Statistics solverStatistics = {0, 0, 0, 0, linearSystems::Converged, 0};
+		mutable linearSystems::Workspace workspace;
+
+		// Where CG starts from, e.g. the solution on the mesh before
+		//  refinement; zero if empty.
+		std::vector<double> initialGuess;
+
+		// The prolongations between the meshes refinement made this one
+		//  from, coarsest first, kept as multigrid levels.
+		std::vector<Matrix_sparse<double>> prolongations;
+
+		// Solvers.
+		std::vector<double> solve_linearSystem(const Matrix_sparse<double> &a_matrix, const std::vector<double> &a_b, const std::vector<double> &a_x0, const double &a_tolerance, linearSystems::Statistics &a_statistics, const double &a_energyTolerance = 0) const;
+		std::vector<double> solve_linearSystem(const Operator_matrixFree &a_operator, const std::vector<double> &a_b, const std::vector<double> &a_x0, const double &a_tolerance, linearSystems::Statistics &a_statistics, const double &a_energyTolerance = 0) const;
+		void solve_adaptively(const std::function<std::vector<double>(const std::vector<double>&, const double&)> &a_solve);
+		std::vector<double> solve_refined(const Matrix_sparse<double> &a_matrix, const Preconditioner* const &a_solver, const std::vector<double> &a_b, const std::vector<double> &a_x0, const linearSystems::StoppingCriteria &a_criteria, linearSystems::Statistics &a_statistics) const;
+		std::vector<double> solve_condensed(const std::vector<double> &a_stiffnessValues, const std::vector<double> &a_b, linearSystems::Statistics &a_statistics) const;
+		std::vector<int> compute_bandedNumbering(const Matrix_sparse<double> &a_matrix) const;
+
+		// Boundary conditions.
+		void apply_boundaryConditions(const int &a_elementNo, const std::vector<int> &a_elementDoFs, double a_K[], std::vector<double> &a_b, const std::vector<double> &a_u = std::vector<double>()) const;
+		void apply_boundaryConditions(Operator_matrixFree &a_operator) const;
+		void apply_dirichletValues(std::vector<double> &a_u) const;
+
 		// Computers.
 		double compute_uh(const int &a_i, const double &a_xi, const int &a_n) const;
 		double compute_uh(const int &a_i, const double &a_xi, const int &a_n, const std::vector<double> &a_u) const;
+		std::vector<double> compute_uh(const int &a_i, const std::vector<double> &a_xi, const int &a_n) const;
+		std::vector<double> compute_uh(const int &a_i, const std::vector<double> &a_xi, const int &a_n, const std::vector<double> &a_u) const;
+		double compute_uhQuadrature(const int &a_i, const int &a_k, const int &a_n) const;
+		double compute_uhQuadrature(const int &a_i, const int &a_k, const int &a_n, const std::vector<double> &a_u) const;
 
 		// Getters.
 		std::vector<int> get_higherOrderDoFs() const;
 
+		// Setters.
+		void set_multigridLevels(const Solution* const &a_solution);
+
 	public:
 		// Destructor.
-		~Solution();
+		virtual ~Solution();
 
 		// Solvers.
 		virtual void Solve(const double &a_cgTolerance) = 0;
@@ -49,9 +94,35 @@ class Solution
 		double compute_globalErrorIndicator() const;
 		double compute_smoothnessIndicator(const int &a_i) const;
 		std::vector<double> compute_smoothnessIndicators() const;
+		std::vector<double> compute_prolongation(Mesh* const &a_mesh) const;
+		Matrix_sparse<double> compute_prolongationMatrix(Mesh* const &a_mesh) const;
 
 		// Getters.
 		bool get_linear() const;
+		linearSystems::Preconditioning get_preconditioning() const;
+		bool get_directSolver() const;
+		bool get_mixedPrecision() const;
+		bool get_staticCondensation() const;
+		linearSystems::Cycle get_multigridCycle() const;
+		bool get_multigridSolver() const;
+		int get_noMultigridLevels() const;
+		const boundaryConditions::Condition& get_boundaryCondition(const boundaryConditions::Side &a_side) const;
+		const linearSystems::StoppingCriteria& get_stoppingCriteria() const;
+		double get_adaptiveFraction() const;
+		const std::vector<double>& get_initialGuess() const;
+		const linearSystems::Statistics& get_solverStatistics() const;
+
+		// Setters.
+		void set_preconditioning(const linearSystems::Preconditioning &a_preconditioning);
+		void set_directSolver(const bool &a_directSolver);
+		void set_mixedPrecision(const bool &a_mixedPrecision);
+		void set_staticCondensation(const bool &a_staticCondensation);
+		void set_multigridCycle(const linearSystems::Cycle &a_multigridCycle);
+		void set_multigridSolver(const bool &a_multigridSolver);
+		void set_boundaryCondition(const boundaryConditions::Side &a_side, const boundaryConditions::Condition &a_condition);
+		void set_stoppingCriteria(const linearSystems::StoppingCriteria &a_stoppingCriteria);
+		void set_adaptiveFraction(const double &a_adaptiveFraction);
+		void set_initialGuess(const std::vector<double> &a_initialGuess);
 
 		// Outputters.
 		void output_solution(f_double const a_u = 0, const std::string a_filename = "../data/solution.dat") const;
@@ -4,13 +4,17 @@
  * @author     Adam Matthew Blakey
  * @date       2019/12/07
  ******************************************************************************/
+#include "basis.hpp"
 #include "common.hpp"
 #include "element.hpp"
 #include "linearSystems.hpp"
 #include "matrix.hpp"
 #include "matrix_full.hpp"
+#include "matrix_sparse.hpp"
 #include "mesh.hpp"
+#include "operator_matrixFree.hpp"
 #include "quadrature.hpp"
+#include "quadratureCache.hpp"
 #include "solution.hpp"
 #include "solution_linear.hpp"
 
@@ -39,6 +43,32 @@ Solution_linear::Solution_linear(Mesh* const &a_mesh, f_double const &a_f, const
 	this->epsilon = a_epsilon;
 	this->c       = a_c;
 	this->linear  = true;
+	this->constantCoefficients = false;
+	this->cValue               = 0;
+	this->massLumping          = false;
+	this->matrixFree           = false;
+
+	this->quadratureCache = QuadratureCache({this->f, this->c});
+	this->quadratureCache.update(this->mesh->elements);
+}
+
+/******************************************************************************
+ * __Solution_linear__
+ * 
+ * @details 	Constructor for a constant reaction coefficient. Element
+ * 				matrices are then scaled copies of the reference matrices, so
+ * 				the stiffness matrix is assembled without quadrature.
+ * 
+ * @param[in] a_mesh 		The mesh the solution is defined on.
+ * @param[in] a_f 			The right-hand side.
+ * @param[in] a_epsilon 	The diffusion coefficient.
+ * @param[in] a_c 			The constant reaction coefficient.
+ ******************************************************************************/
+Solution_linear::Solution_linear(Mesh* const &a_mesh, f_double const &a_f, const double &a_epsilon, const double &a_c)
+: Solution_linear::Solution_linear(a_mesh, a_f, a_epsilon, [a_c](double) -> double { return a_c; })
+{
+	this->constantCoefficients = true;
+	this->cValue               = a_c;
 }
 
 Solution_linear::Solution_linear(Mesh* const &a_mesh, Solution_linear* const &a_solution)
@@ -51,56 +81,173 @@ Solution_linear::Solution_linear(Mesh* const &a_mesh, Solution_linear* const &a_
 	this->epsilon = a_solution->get_epsilon();
 	this->c       = a_solution->get_c();
 	this->linear  = true;
+	this->constantCoefficients = a_solution->constantCoefficients;
+	this->cValue               = a_solution->cValue;
+	this->massLumping          = a_solution->get_massLumping();
+	this->matrixFree           = a_solution->get_matrixFree();
+	this->preconditioning      = a_solution->get_preconditioning();
+	this->directSolver         = a_solution->get_directSolver();
+	this->mixedPrecision       = a_solution->get_mixedPrecision();
+	this->staticCondensation   = a_solution->get_staticCondensation();
+	this->multigridCycle       = a_solution->get_multigridCycle();
+	this->multigridSolver      = a_solution->get_multigridSolver();
+	this->stoppingCriteria     = a_solution->get_stoppingCriteria();
+	this->adaptiveFraction     = a_solution->get_adaptiveFraction();
+	this->boundaryConditions   = a_solution->boundaryConditions;
+
+	// Only elements changed by refinement are re-evaluated.
+	this->quadratureCache = a_solution->quadratureCache;
+	this->quadratureCache.update(this->mesh->elements);
+
+	// CG starts from the old solution, if it has been solved.
+	if (a_solution->solution.size() == a_solution->mesh->elements->get_DoF())
+		this->initialGuess = a_solution->compute_prolongation(a_mesh);
+
+	this->set_multigridLevels(a_solution);
 }
 
-double Solution_linear::l(Element* currentElement, f_double &basis)
+double Solution_linear::l(Element* currentElement, const int &a_basis)
 {
 	double J = currentElement->get_Jacobian();
 	double integral = 0;
 	
-	std::vector<double> coordinates;
-	std::vector<double> weights;
-	currentElement->get_elementQuadrature(coordinates, weights);
+	const quadrature::Rule &rule = currentElement->get_elementQuadrature(quadrature::Load);
+	const double* coordinates = rule.points;
+	const double* weights     = rule.weights;
+
+	const double* basis = currentElement->get_elementBasis(quadrature::Load).get_row(a_basis, 0);
 
-	for (int k=0; k<coordinates.size(); ++k)
+	// Cached values of f, if the rule is the element's usual one.
+	const double* f_values = 0;
+	if (currentElement->get_quadraturePolicy(quadrature::Load) == quadrature::GaussLegendre)
+		f_values = this->quadratureCache.get_values(currentElement->get_elementNo(), 0);
+
+	for (int k=0; k<rule.noPoints; ++k)
 	{
-		double b_value = basis(coordinates[k]);
+		double b_value = basis[k];
 
-		double f_value = this->f(currentElement->mapLocalToGlobal(coordinates[k]));
+		double f_value = (f_values != 0)?f_values[k]:this->f(currentElement->mapLocalToGlobal(coordinates[k]));
 		integral += b_value*f_value*weights[k]*J;
 	}
 
 	return integral;
 }
 
-double Solution_linear::a(Element* currentElement, f_double &basis1, f_double &basis2, f_double &basis1_, f_double &basis2_)
+double Solution_linear::a(Element* currentElement, const int &a_basis1, const int &a_basis2)
 {
 	double J = currentElement->get_Jacobian();
 	double integral = 0;
 	
-	std::vector<double> coordinates;
-	std::vector<double> weights;
-	currentElement->get_elementQuadrature(coordinates, weights);
+	// Stiffness term.
+	const quadrature::Rule &rule = currentElement->get_elementQuadrature(quadrature::Stiffness);
+	const double* weights = rule.weights;
+
+	const basis::Tabulation &tabulation = currentElement->get_elementBasis(quadrature::Stiffness);
+	const double* basis1_ = tabulation.get_row(a_basis1, 1);
+	const double* basis2_ = tabulation.get_row(a_basis2, 1);
 
-	for (int k=0; k<coordinates.size(); ++k)
+	for (int k=0; k<rule.noPoints; ++k)
 	{
-		double b_value = basis1_(coordinates[k]) * basis2_(coordinates[k]);
+		double b_value = basis1_[k] * basis2_[k];
 
 		integral += this->epsilon*b_value*weights[k]/J;
 	}
 
-	for (int k=0; k<coordinates.size(); ++k)
+	// Mass term; a lumped mass matrix keeps only its diagonal.
+	if (this->massLumping && a_basis1 != a_basis2)
+		return integral;
+
+	const quadrature::Rule &massRule = currentElement->get_elementQuadrature(quadrature::Mass);
+	const double* massCoordinates = massRule.points;
+	const double* massWeights     = massRule.weights;
+
+	const basis::Tabulation &massTabulation = currentElement->get_elementBasis(quadrature::Mass);
+	const double* basis1 = massTabulation.get_row(a_basis1, 0);
+	const double* basis2 = massTabulation.get_row(a_basis2, 0);
+
+	// Cached values of c, if the rule is the element's usual one.
+	const double* c_values = 0;
+	if (currentElement->get_quadraturePolicy(quadrature::Mass) == quadrature::GaussLegendre)
+		c_values = this->quadratureCache.get_values(currentElement->get_elementNo(), 1);
+
+	for (int k=0; k<massRule.noPoints; ++k)
 	{
-		double b_value = basis1(coordinates[k]) * basis2(coordinates[k]);
+		double b_value = basis1[k] * basis2[k];
 
-		double c_value = this->c(currentElement->mapLocalToGlobal(coordinates[k]));
+		double c_value = (c_values != 0)?c_values[k]:this->c(currentElement->mapLocalToGlobal(massCoordinates[k]));
 
-		integral += c_value*b_value*weights[k]*J;
+		integral += c_value*b_value*massWeights[k]*J;
 	}
 
 	return integral;
 }
 
+/******************************************************************************
+ * __check_massLumping__
+ * 
+ * @details 	Only linear elements have a nodal basis; the higher-order shape
+ * 				functions are hierarchical, so neither dropping their
+ * 				off-diagonal mass entries nor summing rows is consistent. On a
+ * 				mesh with any other element, e.g. after p-refinement, lumping
+ * 				is turned off and the consistent mass matrix used instead.
+ * 
+ * @return 		Whether the mass term is to be lumped.
+ ******************************************************************************/
+bool Solution_linear::check_massLumping()
+{
+	if (!this->massLumping)
+		return false;
+
+	for (int elementCounter=0; elementCounter<this->noElements; ++elementCounter)
+		if ((*(this->mesh->elements))[elementCounter]->get_polynomialDegree() != 1)
+		{
+			std::cerr << "Error: Mass lumping needs linear elements; the consistent mass matrix is used." << std::endl;
+			this->massLumping = false;
+			return false;
+		}
+
+	return true;
+}
+
+/******************************************************************************
+ * __set_lumpedMassQuadrature__
+ * 
+ * @details 	Integrates the mass term of every element with the Gauss-Lobatto
+ * 				rule on the nodes, so that its mass matrix is diagonal. The
+ * 				elements must be linear; see check_massLumping.
+ * 
+ * @return 		The Mass policies the elements had, for set_massQuadrature.
+ ******************************************************************************/
+std::vector<quadrature::Family> Solution_linear::set_lumpedMassQuadrature()
+{
+	std::vector<quadrature::Family> policies(this->noElements);
+
+	for (int elementCounter=0; elementCounter<this->noElements; ++elementCounter)
+	{
+		Element* currentElement = (*(this->mesh->elements))[elementCounter];
+		assert(currentElement->get_polynomialDegree() == 1);
+
+		policies[elementCounter] = currentElement->get_quadraturePolicy(quadrature::Mass);
+		currentElement->set_quadraturePolicy(quadrature::Mass, quadrature::GaussLobatto);
+	}
+
+	return policies;
+}
+
+/******************************************************************************
+ * __set_massQuadrature__
+ * 
+ * @details 	Gives every element back the Mass policy it had before
+ * 				set_lumpedMassQuadrature.
+ * 
+ * @param[in] a_policies 	The policies, as set_lumpedMassQuadrature returned.
+ ******************************************************************************/
+void Solution_linear::set_massQuadrature(const std::vector<quadrature::Family> &a_policies)
+{
+	for (int elementCounter=0; elementCounter<this->noElements; ++elementCounter)
+		(*(this->mesh->elements))[elementCounter]->set_quadraturePolicy(quadrature::Mass, a_policies[elementCounter]);
+}
+
 /******************************************************************************
  * __Solve__
  * 
@@ -109,86 +256,174 @@ double Solution_linear::a(Element* currentElement, f_double &basis1, f_double &b
  ******************************************************************************/
 void Solution_linear::Solve(const double &a_cgTolerance)
 {
-	double A = 0;
-	double B = 0;
+	this->check_massLumping();
+
+	if (this->matrixFree)
+	{
+		this->Solve_matrixFree(a_cgTolerance);
+		return;
+	}
 
 	int n = this->mesh->elements->get_DoF();//this->noElements + 1; // Number of nodes.
 
 	Elements* elements = this->mesh->elements;
 
-	Matrix_full<double> stiffnessMatrix(n, n, 0);
+	// Symbolic phase; the values are gathered in the same order below.
+	std::vector<int> xs;
+	std::vector<int> ys;
+	elements->get_assemblyPattern(xs, ys);
+
+	Matrix_sparse<double> stiffnessMatrix(n, n, xs, ys);
+	std::vector<double> stiffnessValues;
 	std::vector<double> loadVector(n, 0);
 
+	stiffnessValues.reserve(xs.size());
+
+	this->quadratureCache.update(this->mesh->elements);
+
+	std::vector<quadrature::Family> massPolicies;
+	if (this->massLumping)
+		massPolicies = this->set_lumpedMassQuadrature();
+
 	for (int elementCounter=0; elementCounter<this->noElements; ++elementCounter)
 	{
 		Element* currentElement = (*(this->mesh->elements))[elementCounter];
 		int polynomialDegree = currentElement->get_polynomialDegree();
 
-		double elementLeft  = currentElement->get_nodeCoordinates()[0];
-		double elementRight = currentElement->get_nodeCoordinates()[1];
+		double elementLeft  = currentElement->get_leftNode();
+		double elementRight = currentElement->get_rightNode();
 
 		std::vector<int> elementDoFs = elements->get_elementDoFs(elementCounter);
 		for (int a=0; a<elementDoFs.size(); ++a)
+			loadVector[elementDoFs[a]] += this->l(currentElement, a);
+
+		int N = elementDoFs.size();
+
+		if (this->constantCoefficients)
 		{
-			int j = elementDoFs[a];
-			f_double basis = currentElement->basisFunction(a, 0);
-
-			loadVector[j] += this->l(currentElement, basis);
-
-			for (int b=0; b<elementDoFs.size(); ++b)
-			{
-				int i = elementDoFs[b];
-				f_double basis1  = currentElement->basisFunction(b, 0);
-				f_double basis2  = currentElement->basisFunction(a, 0);
-				f_double basis1_ = currentElement->basisFunction(b, 1);
-				f_double basis2_ = currentElement->basisFunction(a, 1);
-
-				double value = stiffnessMatrix(i, j); // Bit messy...
-				stiffnessMatrix.set(i, j, value + this->a(currentElement, basis1, basis2, basis1_, basis2_));
-			}
+			// Scatters the scaled reference matrices.
+			double J = currentElement->get_Jacobian();
+
+			const double* K = basis::get_referenceMatrix(polynomialDegree, 1,
+				currentElement->get_noQuadraturePoints(quadrature::Stiffness),
+				currentElement->get_quadraturePolicy(quadrature::Stiffness));
+			const double* M = basis::get_referenceMatrix(polynomialDegree, 0,
+				currentElement->get_noQuadraturePoints(quadrature::Mass),
+				currentElement->get_quadraturePolicy(quadrature::Mass));
+
+			for (int a=0; a<elementDoFs.size(); ++a)
+				for (int b=0; b<elementDoFs.size(); ++b)
+				{
+					double K_ba = K[b*N + a];
+					double M_ba = (this->massLumping && a != b)?0:M[b*N + a];
+
+					stiffnessValues.push_back(this->epsilon*K_ba/J + this->cValue*M_ba*J);
+				}
 		}
+		else
+			for (int a=0; a<elementDoFs.size(); ++a)
+				for (int b=0; b<elementDoFs.size(); ++b)
+					stiffnessValues.push_back(this->a(currentElement, b, a));
+
+		this->apply_boundaryConditions(elementCounter, elementDoFs, stiffnessValues.data() + stiffnessValues.size() - N*N, loadVector);
 	}
 
-	std::vector<double> F_(n);
-	std::vector<double> u0(n, 0);
+	if (this->massLumping)
+		this->set_massQuadrature(massPolicies);
 
-	int m = this->mesh->elements->get_noElements(); // Only works in 1D!
-	
-	for (int i=0; i<stiffnessMatrix.get_noRows(); ++i)
-		stiffnessMatrix.set(0, i, 0);
-	for (int j=0; j<stiffnessMatrix.get_noColumns(); ++j)
-		stiffnessMatrix.set(j, 0, 0);
-	loadVector[0] = 0;
-
-	for (int i=0; i<stiffnessMatrix.get_noRows(); ++i)
-		stiffnessMatrix.set(m, i, 0);
-	for (int j=0; j<stiffnessMatrix.get_noColumns(); ++j)
-		stiffnessMatrix.set(j, m, 0);
-	loadVector[m] = 0;
-
-	u0[0] = A;
-	u0[m] = B;
-	
-	F_ = stiffnessMatrix*u0;
-	for (int i=0; i<n; ++i)
-		loadVector[i] -= F_[i];
+	if (this->staticCondensation)
+	{
+		this->solution = this->solve_condensed(stiffnessValues, loadVector, this->solverStatistics);
+		return;
+	}
+
+	// Numeric phase.
+	stiffnessMatrix.set_values(stiffnessValues);
+
+	this->solve_adaptively([&](const std::vector<double> &a_x0, const double &a_energyTolerance)
+	{
+		return this->solve_linearSystem(stiffnessMatrix, loadVector, a_x0, a_cgTolerance, this->solverStatistics, a_energyTolerance);
+	});
+
+	this->apply_dirichletValues(this->solution);
+}
+
+/******************************************************************************
+ * __Solve_matrixFree__
+ * 
+ * @details 	As Solve, but CG applies the stiffness matrix element by
+ * 				element through an Operator_matrixFree instead of assembling
+ * 				it.
+ ******************************************************************************/
+void Solution_linear::Solve_matrixFree(const double &a_cgTolerance)
+{
+	this->check_massLumping();
+
+	int n = this->mesh->elements->get_DoF();
+
+	Elements* elements = this->mesh->elements;
+
+	std::vector<double> loadVector(n, 0);
+
+	this->quadratureCache.update(this->mesh->elements);
+
+	std::vector<quadrature::Family> massPolicies;
+	if (this->massLumping)
+		massPolicies = this->set_lumpedMassQuadrature();
+
+	for (int elementCounter=0; elementCounter<this->noElements; ++elementCounter)
+	{
+		Element* currentElement = (*(this->mesh->elements))[elementCounter];
+
+		std::vector<int> elementDoFs = elements->get_elementDoFs(elementCounter);
+		for (int a=0; a<elementDoFs.size(); ++a)
+			loadVector[elementDoFs[a]] += this->l(currentElement, a);
+
+		// Only the end elements' matrices are needed, for the boundary
+		//  conditions.
+		if (elementCounter == 0 || elementCounter == this->noElements-1)
+		{
+			int N = elementDoFs.size();
+			std::vector<double> K(N*N);
+			for (int a=0; a<N; ++a)
+				for (int b=0; b<N; ++b)
+					K[a*N + b] = this->a(currentElement, b, a);
+
+			this->apply_boundaryConditions(elementCounter, elementDoFs, K.data(), loadVector);
+		}
+	}
+
+	Operator_matrixFree stiffnessOperator(elements, this->massLumping);
+
+	f_pointCoefficient epsilon = [this](Element*, const int&) -> double
+	{
+		return this->epsilon;
+	};
+
+	// Cached values of c, if the rule is the element's usual one.
+	f_pointCoefficient c = [this](Element* a_element, const int &a_k) -> double
+	{
+		if (this->constantCoefficients)
+			return this->cValue;
+		if (a_element->get_quadraturePolicy(quadrature::Mass) == quadrature::GaussLegendre)
+			return this->quadratureCache.get_values(a_element->get_elementNo(), 1)[a_k];
+
+		return this->c(a_element->mapLocalToGlobal(a_element->get_elementQuadrature(quadrature::Mass).points[a_k]));
+	};
 
-	for (int i=0; i<stiffnessMatrix.get_noRows(); ++i)
-		stiffnessMatrix.set(0, i, 0);
-	for (int j=0; j<stiffnessMatrix.get_noColumns(); ++j)
-		stiffnessMatrix.set(j, 0, 0);
-	stiffnessMatrix.set(0, 0, 1);
+	stiffnessOperator.set_coefficients(elements, epsilon, c);
 
-	for (int i=0; i<stiffnessMatrix.get_noRows(); ++i)
-		stiffnessMatrix.set(m, i, 0);
-	for (int j=0; j<stiffnessMatrix.get_noColumns(); ++j)
-		stiffnessMatrix.set(j, m, 0);
-	stiffnessMatrix.set(m, m, 1);
+	if (this->massLumping)
+		this->set_massQuadrature(massPolicies);
 
-	this->solution = linearSystems::conjugateGradient(stiffnessMatrix, loadVector, a_cgTolerance);
+	this->apply_boundaryConditions(stiffnessOperator);
 
-	this->solution[0] = A;
-	this->solution[m] = B;
+	this->solve_adaptively([&](const std::vector<double> &a_x0, const double &a_energyTolerance)
+	{
+		return this->solve_linearSystem(stiffnessOperator, loadVector, a_x0, a_cgTolerance, this->solverStatistics, a_energyTolerance);
+	});
+
+	this->apply_dirichletValues(this->solution);
 }
 
 f_double Solution_linear::get_f() const
@@ -206,9 +441,60 @@ f_double Solution_linear::get_c() const
 	return this->c;
 }
 
+bool Solution_linear::get_constantCoefficients() const
+{
+	return this->constantCoefficients;
+}
+
+bool Solution_linear::get_massLumping() const
+{
+	return this->massLumping;
+}
+
+bool Solution_linear::get_matrixFree() const
+{
+	return this->matrixFree;
+}
+
+/******************************************************************************
+ * __set_massLumping__
+ * 
+ * @details 	Chooses whether the mass term of the stiffness matrix is lumped.
+ * 				A lumped mass term is integrated with the Gauss-Lobatto rule on
+ * 				the nodes and only its diagonal is kept, which is the usual
+ * 				lumped mass matrix. Only meshes of linear elements can be
+ * 				lumped; on others this is an error, and the consistent mass
+ * 				matrix is kept.
+ * 
+ * @param[in] a_massLumping 	Whether to lump the mass term.
+ ******************************************************************************/
+void Solution_linear::set_massLumping(const bool &a_massLumping)
+{
+	this->massLumping = a_massLumping;
+	this->check_massLumping();
+}
+
+/******************************************************************************
+ * __set_matrixFree__
+ * 
+ * @details 	Chooses whether Solve applies the stiffness matrix element by
+ * 				element instead of assembling it.
+ * 
+ * @param[in] a_matrixFree 	Whether to solve matrix-free.
+ ******************************************************************************/
+void Solution_linear::set_matrixFree(const bool &a_matrixFree)
+{
+	this->matrixFree = a_matrixFree;
+}
+
 double Solution_linear::compute_residual(const double &a_uh, const double &a_uh_2, const double &a_x) const
 {
-	return this->f(a_x) + this->epsilon*a_uh_2 - this->c(a_x)*a_uh;
+	return compute_residual(a_uh, a_uh_2, this->f(a_x), this->c(a_x));
+}
+
+double Solution_linear::compute_residual(const double &a_uh, const double &a_uh_2, const double &a_f, const double &a_c) const
+{
+	return a_f + this->epsilon*a_uh_2 - a_c*a_uh;
 }
 
 double Solution_linear::compute_energyNormDifference2(f_double const &a_u, f_double const &a_u_1) const
@@ -224,22 +510,23 @@ double Solution_linear::compute_energyNormDifference2(f_double const &a_u, f_dou
 		Element* currentElement = (*(this->mesh->elements))[i];
 
 		// Retrieves quadrature information.
-		std::vector<double> coordinates;
-		std::vector<double> weights;
-		currentElement->get_elementQuadrature(coordinates, weights);
+		const quadrature::Rule &rule = currentElement->get_elementQuadrature();
+		const double* coordinates = this->quadratureCache.get_points(i);
+		const double* c_values    = this->quadratureCache.get_values(i, 1);
+		const double* weights     = rule.weights;
 
-		for (int j=0; j<coordinates.size(); ++j)
+		for (int j=0; j<rule.noPoints; ++j)
 		{			
 			// Actual and approximate solution at coordinates.
-			double uh   = compute_uh(i, coordinates[j], 0);
-			double uh_1 = compute_uh(i, coordinates[j], 1);
-			double u    = a_u  (currentElement->mapLocalToGlobal(coordinates[j]));
-			double u_1  = a_u_1(currentElement->mapLocalToGlobal(coordinates[j]));
+			double uh   = compute_uhQuadrature(i, j, 0);
+			double uh_1 = compute_uhQuadrature(i, j, 1);
+			double u    = a_u  (coordinates[j]);
+			double u_1  = a_u_1(coordinates[j]);
 
 			double Jacobian = currentElement->get_Jacobian();
 
 			norm += pow(sqrt_epsilon*(u_1 - uh_1), 2)*weights[j]*Jacobian
-				 +  pow(sqrt(this->c(currentElement->mapLocalToGlobal(coordinates[j])))*(u - uh), 2)*weights[j]*Jacobian;
+				 +  pow(sqrt(c_values[j])*(u - uh), 2)*weights[j]*Jacobian;
 		}
 	}
 
@@ -251,24 +538,26 @@ double Solution_linear::compute_errorIndicator(const double &a_i) const
 	// Gets element and its properties.
 	Element* currentElement = (*(this->mesh->elements))[a_i];
 	int P = currentElement->get_polynomialDegree();
-	double leftNode  = currentElement->get_nodeCoordinates()[0];
-	double rightNode = currentElement->get_nodeCoordinates()[1];
+	double leftNode  = currentElement->get_leftNode();
+	double rightNode = currentElement->get_rightNode();
 	double Jacobian  = currentElement->get_Jacobian();
 
 	// Calculates L2 norm on element with weight and residual.
 	double norm_2 = 0;
-	std::vector<double> quadratureCoordinates;
-	std::vector<double> quadratureWeights;
-	currentElement->get_elementQuadrature(quadratureCoordinates, quadratureWeights);
+	const quadrature::Rule &rule = currentElement->get_elementQuadrature();
+	const double* quadratureCoordinates = this->quadratureCache.get_points(a_i);
+	const double* f_values              = this->quadratureCache.get_values(a_i, 0);
+	const double* c_values              = this->quadratureCache.get_values(a_i, 1);
+	const double* quadratureWeights     = rule.weights;
 
 	// Loops over quadrature coordinates and weights.
-	for (int j=0; j<quadratureCoordinates.size(); ++j)
+	for (int j=0; j<rule.noPoints; ++j)
 	{
-		double uh   = compute_uh(a_i, quadratureCoordinates[j], 0);
-		double uh_2 = compute_uh(a_i, quadratureCoordinates[j], 2);
-		double residual = compute_residual(uh, uh_2, currentElement->mapLocalToGlobal(quadratureCoordinates[j]));
+		double uh   = compute_uhQuadrature(a_i, j, 0);
+		double uh_2 = compute_uhQuadrature(a_i, j, 2);
+		double residual = compute_residual(uh, uh_2, f_values[j], c_values[j]);
 
-		double x = currentElement->mapLocalToGlobal(quadratureCoordinates[j]);
+		double x = quadratureCoordinates[j];
 		double weight = (rightNode - x)*(x - leftNode);
 
 		norm_2 += pow(sqrt(weight)*residual, 2)*quadratureWeights[j]*Jacobian;
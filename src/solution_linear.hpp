@@ -8,6 +8,7 @@
 #define CLASS_SOLUTIONLINEAR
 
 #include "common.hpp"
+#include "quadratureCache.hpp"
 #include "solution.hpp"
 #include <vector>
 
@@ -18,21 +19,39 @@ class Solution_linear : public Solution
 		f_double f;
 		double epsilon;
 		f_double c;
+		bool constantCoefficients;
+		double cValue;
+		bool massLumping;
+		bool matrixFree;
+
+		// Quadrature points with the values of f and c there.
+		QuadratureCache quadratureCache;
 
 		// Computes stiffness and load vector terms.
-		double a(Element* currentElement, f_double &basis1, f_double &basis2, f_double &basis1_, f_double &basis2_);
-		double l(Element* currentElement, f_double &basis);
+		double a(Element* currentElement, const int &a_basis1, const int &a_basis2);
+		double l(Element* currentElement, const int &a_basis);
+
+		// Turns lumping off on meshes that are not all linear elements.
+		bool check_massLumping();
+
+		// Switches the Mass rule of every element to Gauss-Lobatto while the
+		//  mass term is lumped, and back.
+		std::vector<quadrature::Family> set_lumpedMassQuadrature();
+		void set_massQuadrature(const std::vector<quadrature::Family> &a_policies);
 
 		// Computers.
 		double compute_residual(const double &a_uh, const double &a_uh_2, const double &a_x) const;
+		double compute_residual(const double &a_uh, const double &a_uh_2, const double &a_f, const double &a_c) const;
 
 	public:
 		// Constructors.
 		Solution_linear(Mesh* const &a_mesh, Solution_linear* const &a_solution);
 		Solution_linear(Mesh* const &a_mesh, f_double const &a_f, const double &a_epsilon, f_double const &a_c);
+		Solution_linear(Mesh* const &a_mesh, f_double const &a_f, const double &a_epsilon, const double &a_c);
 
 		// Solvers.
 		void Solve(const double &a_cgTolerance);
+		void Solve_matrixFree(const double &a_cgTolerance);
 
 		// Computers.
 		double compute_energyNormDifference2(f_double const &a_u, f_double const &a_u_1) const;
@@ -42,6 +61,13 @@ class Solution_linear : public Solution
 		f_double get_f() const;
 		double get_epsilon() const;
 		f_double get_c() const;
+		bool get_constantCoefficients() const;
+		bool get_massLumping() const;
+		bool get_matrixFree() const;
+
+		// Setters.
+		void set_massLumping(const bool &a_massLumping);
+		void set_matrixFree(const bool &a_matrixFree);
 };
 
 #endif
\ No newline at end of file
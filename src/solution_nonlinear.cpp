@@ -4,11 +4,13 @@
  * @author     Adam Matthew Blakey
  * @date       2019/12/07
  ******************************************************************************/
+#include "basis.hpp"
 #include "common.hpp"
 #include "element.hpp"
 #include "linearSystems.hpp"
 #include "matrix.hpp"
 #include "matrix_full.hpp"
+#include "matrix_sparse.hpp"
 #include "mesh.hpp"
 #include "quadrature.hpp"
 #include "solution.hpp"
@@ -39,6 +41,7 @@ Solution_nonlinear::Solution_nonlinear(Mesh* const &a_mesh, f_double2 const &a_f
 	this->f_      = a_f_;
 	this->epsilon = a_epsilon;
 	this->linear  = true;
+	this->matrixFree = false;
 }
 
 Solution_nonlinear::Solution_nonlinear(Mesh* const &a_mesh, Solution_nonlinear* const &a_solution)
@@ -51,24 +54,43 @@ Solution_nonlinear::Solution_nonlinear(Mesh* const &a_mesh, Solution_nonlinear*
 	this->f_      = a_solution->get_f_();
 	this->epsilon = a_solution->get_epsilon();
 	this->linear  = true;
+	this->matrixFree = a_solution->get_matrixFree();
+	this->preconditioning = a_solution->get_preconditioning();
+	this->directSolver = a_solution->get_directSolver();
+	this->mixedPrecision = a_solution->get_mixedPrecision();
+	this->staticCondensation = a_solution->get_staticCondensation();
+	this->multigridCycle = a_solution->get_multigridCycle();
+	this->multigridSolver = a_solution->get_multigridSolver();
+	this->stoppingCriteria = a_solution->get_stoppingCriteria();
+	this->boundaryConditions = a_solution->boundaryConditions;
+
+	// Newton starts from the old solution, if it has been solved.
+	if (a_solution->solution.size() == a_solution->mesh->elements->get_DoF())
+		this->initialGuess = a_solution->compute_prolongation(a_mesh);
+
+	this->set_multigridLevels(a_solution);
 }
 
-double Solution_nonlinear::l(Element* currentElement, f_double &basis, f_double &basis_, const std::vector<double> &u) const
+double Solution_nonlinear::l(Element* currentElement, const int &a_basis, const std::vector<double> &u) const
 {
 	double J = currentElement->get_Jacobian();
 	double integral = 0;
 	
-	std::vector<double> coordinates;
-	std::vector<double> weights;
-	currentElement->get_elementQuadrature(coordinates, weights);
+	const quadrature::Rule &rule = currentElement->get_elementQuadrature();
+	const double* coordinates = rule.points;
+	const double* weights     = rule.weights;
 
-	for (int k=0; k<coordinates.size(); ++k)
+	const basis::Tabulation &tabulation = currentElement->get_elementBasis();
+	const double* basis  = tabulation.get_row(a_basis, 0);
+	const double* basis_ = tabulation.get_row(a_basis, 1);
+
+	for (int k=0; k<rule.noPoints; ++k)
 	{
-		double b_value  = basis(coordinates[k]);
-		double b_value_ = basis_(coordinates[k]);
+		double b_value  = basis[k];
+		double b_value_ = basis_[k];
 		double x_value  = currentElement->mapLocalToGlobal(coordinates[k]);
-		double u_value  = compute_uh(currentElement->get_elementNo(), coordinates[k], 0, u);
-		double u_value_ = compute_uh(currentElement->get_elementNo(), coordinates[k], 1, u);
+		double u_value  = compute_uhQuadrature(currentElement->get_elementNo(), k, 0, u);
+		double u_value_ = compute_uhQuadrature(currentElement->get_elementNo(), k, 1, u);
 		double f_value  = this->f(x_value, u_value);
 		
 		integral += this->epsilon*u_value_*b_value_*weights[k] + f_value*b_value*weights[k]*J;
@@ -77,23 +99,29 @@ double Solution_nonlinear::l(Element* currentElement, f_double &basis, f_double
 	return integral;
 }
 
-double Solution_nonlinear::a(Element* currentElement, f_double &basis1, f_double &basis2, f_double &basis1_, f_double &basis2_, const std::vector<double> &u) const
+double Solution_nonlinear::a(Element* currentElement, const int &a_basis1, const int &a_basis2, const std::vector<double> &u) const
 {
 	double J = currentElement->get_Jacobian();
 	double integral = 0;
 	
-	std::vector<double> coordinates;
-	std::vector<double> weights;
-	currentElement->get_elementQuadrature(coordinates, weights);
+	const quadrature::Rule &rule = currentElement->get_elementQuadrature();
+	const double* coordinates = rule.points;
+	const double* weights     = rule.weights;
+
+	const basis::Tabulation &tabulation = currentElement->get_elementBasis();
+	const double* basis1  = tabulation.get_row(a_basis1, 0);
+	const double* basis2  = tabulation.get_row(a_basis2, 0);
+	const double* basis1_ = tabulation.get_row(a_basis1, 1);
+	const double* basis2_ = tabulation.get_row(a_basis2, 1);
 
-	for (int k=0; k<coordinates.size(); ++k)
+	for (int k=0; k<rule.noPoints; ++k)
 	{
-		double b_value1  = basis1(coordinates[k]);
-		double b_value1_ = basis1_(coordinates[k]);
-		double b_value2  = basis2(coordinates[k]);
-		double b_value2_ = basis2_(coordinates[k]);
+		double b_value1  = basis1[k];
+		double b_value1_ = basis1_[k];
+		double b_value2  = basis2[k];
+		double b_value2_ = basis2_[k];
 		double x_value   = currentElement->mapLocalToGlobal(coordinates[k]);
-		double u_value   = compute_uh(currentElement->get_elementNo(), coordinates[k], 0, u);
+		double u_value   = compute_uhQuadrature(currentElement->get_elementNo(), k, 0, u);
 		double f_value   = this->f_(x_value, u_value);
 
 		integral += this->epsilon*b_value1_*b_value2_*weights[k]/J + f_value*b_value1*b_value2*weights[k]*J;
@@ -110,7 +138,12 @@ double Solution_nonlinear::a(Element* currentElement, f_double &basis1, f_double
  ******************************************************************************/
 void Solution_nonlinear::Solve(const double &a_cgTolerance)
 {
+	// The initial guess, if any, in the NodesFirst numbering.
 	std::vector<double> u0(this->mesh->elements->get_DoF());
+	if (!this->initialGuess.empty())
+		for (int i=0; i<u0.size(); ++i)
+			u0[i] = this->initialGuess[this->mesh->elements->get_DoFNumber(i)];
+
 	this->Solve(a_cgTolerance, 1e-15, u0);
 }
 
@@ -142,8 +175,8 @@ void Solution_nonlinear::Solve(const double &a_cgTolerance)
 			Element* currentElement = (*(this->mesh->elements))[elementCounter];
 			int polynomialDegree = currentElement->get_polynomialDegree();
 
-			double elementLeft  = currentElement->get_nodeCoordinates()[0];
-			double elementRight = currentElement->get_nodeCoordinates()[1];
+			double elementLeft  = currentElement->get_leftNode();
+			double elementRight = currentElement->get_rightNode();
 
 			std::vector<int> elementDoFs = elements->get_elementDoFs(elementCounter);
 			for (int a=0; a<elementDoFs.size(); ++a)
@@ -411,18 +444,16 @@ void Solution_nonlinear::Solve(const double &a_cgTolerance)
 	this->solution = next_x;
 }*/
 
-void Solution_nonlinear::Solve_single(const double &a_cgTolerance, const double &a_NewtonTolerance, const std::vector<double> &a_uPrev, std::vector<double> &a_uNext, double &a_difference) const
+void Solution_nonlinear::Solve_single(Matrix_sparse<double> &a_stiffnessMatrix, const double &a_cgTolerance, const double &a_NewtonTolerance, const std::vector<double> &a_uPrev, std::vector<double> &a_uNext, double &a_difference, linearSystems::Statistics &a_statistics) const
 {
-	// Problem details.
-    double A = 0;
-	double B = 0;
-
 	// Variables to make life easy!
 	int n = this->mesh->elements->get_DoF();
 	Elements* elements = this->mesh->elements;
 
-	// Inverse Jacobian matrix at the previous x.
-	Matrix_full<double> stiffnessMatrix(n, n, 0);
+	// Inverse Jacobian matrix at the previous x, refilling the pattern of
+	//  Elements::get_assemblyPattern.
+	Matrix_sparse<double> &stiffnessMatrix = a_stiffnessMatrix;
+	std::vector<double> stiffnessValues;
 	std::vector<double> loadVector(n, 0);
 
 	// Loops over all combinations of basis functions.
@@ -431,69 +462,40 @@ void Solution_nonlinear::Solve_single(const double &a_cgTolerance, const double
 		Element* currentElement = (*(this->mesh->elements))[elementCounter];
 		int polynomialDegree = currentElement->get_polynomialDegree();
 
-		double elementLeft  = currentElement->get_nodeCoordinates()[0];
-		double elementRight = currentElement->get_nodeCoordinates()[1];
+		double elementLeft  = currentElement->get_leftNode();
+		double elementRight = currentElement->get_rightNode();
 
 		std::vector<int> elementDoFs = elements->get_elementDoFs(elementCounter);
 		for (int a=0; a<elementDoFs.size(); ++a)
 		{
 			int j = elementDoFs[a];
-			f_double basis  = currentElement->basisFunction(a, 0);
-			f_double basis_ = currentElement->basisFunction(a, 1);
 
-			loadVector[j] += this->l(currentElement, basis, basis_, a_uPrev);
+			loadVector[j] += this->l(currentElement, a, a_uPrev);
 
 			for (int b=0; b<elementDoFs.size(); ++b)
-			{
-				int i = elementDoFs[b];
-				f_double basis1  = currentElement->basisFunction(b, 0);
-				f_double basis2  = currentElement->basisFunction(a, 0);
-				f_double basis1_ = currentElement->basisFunction(b, 1);
-				f_double basis2_ = currentElement->basisFunction(a, 1);
-
-				double value = stiffnessMatrix(i, j); // Bit messy...
-				stiffnessMatrix.set(i, j, value + this->a(currentElement, basis1, basis2, basis1_, basis2_, a_uPrev));
-			}
+				stiffnessValues.push_back(this->a(currentElement, b, a, a_uPrev));
 		}
+
+		int N = elementDoFs.size();
+		this->apply_boundaryConditions(elementCounter, elementDoFs, stiffnessValues.data() + stiffnessValues.size() - N*N, loadVector, a_uPrev);
 	}
 
-	std::vector<double> F_(n);
-	std::vector<double> u0(n, 0);
+	if (this->staticCondensation)
+	{
+		std::vector<double> update = this->solve_condensed(stiffnessValues, loadVector, a_statistics);
 
-	int m = this->mesh->elements->get_noElements(); // Only works in 1D!
+		for (int i=0; i<a_uNext.size(); ++i)
+			a_uNext[i] = a_uPrev[i] - update[i];
 
-	for (int i=0; i<stiffnessMatrix.get_noRows(); ++i)
-		stiffnessMatrix.set(0, i, 0);
-	for (int j=0; j<stiffnessMatrix.get_noColumns(); ++j)
-		stiffnessMatrix.set(j, 0, 0);
-	loadVector[0] = 0;
+		this->apply_dirichletValues(a_uNext);
 
-	for (int i=0; i<stiffnessMatrix.get_noRows(); ++i)
-		stiffnessMatrix.set(m, i, 0);
-	for (int j=0; j<stiffnessMatrix.get_noColumns(); ++j)
-		stiffnessMatrix.set(j, m, 0);
-	loadVector[m] = 0;
+		a_difference = common::l2Norm(a_uNext, a_uPrev);
+		return;
+	}
 
-	u0[0] = 0;
-	u0[m] = 0;
-	
-	F_ = stiffnessMatrix*u0;
-	for (int i=0; i<n; ++i)
-		loadVector[i] -= F_[i];
-
-	for (int i=0; i<stiffnessMatrix.get_noRows(); ++i)
-		stiffnessMatrix.set(0, i, 0);
-	for (int j=0; j<stiffnessMatrix.get_noColumns(); ++j)
-		stiffnessMatrix.set(j, 0, 0);
-	stiffnessMatrix.set(0, 0, 1);
-
-	for (int i=0; i<stiffnessMatrix.get_noRows(); ++i)
-		stiffnessMatrix.set(m, i, 0);
-	for (int j=0; j<stiffnessMatrix.get_noColumns(); ++j)
-		stiffnessMatrix.set(j, m, 0);
-	stiffnessMatrix.set(m, m, 1);
-	
-	std::vector<double> update = linearSystems::conjugateGradient(stiffnessMatrix, loadVector, a_cgTolerance);
+	stiffnessMatrix.set_values(stiffnessValues);
+
+	std::vector<double> update = this->solve_linearSystem(stiffnessMatrix, loadVector, {}, a_cgTolerance, a_statistics);
 
 	double damping = 1;//std::min(sqrt(2*a_NewtonTolerance/compute_epsilonNorm(a_uPrev)), double(1)); // Not quite right.
 
@@ -501,8 +503,7 @@ void Solution_nonlinear::Solve_single(const double &a_cgTolerance, const double
 	for (int i=0; i<a_uNext.size(); ++i)
 		a_uNext[i] = a_uPrev[i] - damping*update[i];
 
-	a_uNext[0] = A;
-	a_uNext[m] = B;
+	this->apply_dirichletValues(a_uNext);
 
     // Returns the difference.
     a_difference = common::l2Norm(a_uNext, a_uPrev);
@@ -511,11 +512,97 @@ void Solution_nonlinear::Solve_single(const double &a_cgTolerance, const double
     std::cout << std::endl;*/
 }
 
+/******************************************************************************
+ * __Solve_single__
+ * 
+ * @details 	One Newton step with the Jacobian applied matrix-free: only
+ * 				the values of f_ at the quadrature points are recomputed.
+ * 
+ * @param[in] a_stiffnessOperator 	The Jacobian, with its Dirichlet DoFs set.
+ ******************************************************************************/
+void Solution_nonlinear::Solve_single(Operator_matrixFree &a_stiffnessOperator, const double &a_cgTolerance, const std::vector<double> &a_uPrev, std::vector<double> &a_uNext, double &a_difference, linearSystems::Statistics &a_statistics) const
+{
+	int n = this->mesh->elements->get_DoF();
+	Elements* elements = this->mesh->elements;
+
+	std::vector<double> loadVector(n, 0);
+
+	for (int elementCounter=0; elementCounter<this->noElements; ++elementCounter)
+	{
+		Element* currentElement = (*(this->mesh->elements))[elementCounter];
+
+		std::vector<int> elementDoFs = elements->get_elementDoFs(elementCounter);
+		for (int a=0; a<elementDoFs.size(); ++a)
+			loadVector[elementDoFs[a]] += this->l(currentElement, a, a_uPrev);
+
+		// Only the end elements' matrices are needed, for the boundary
+		//  conditions.
+		if (elementCounter == 0 || elementCounter == this->noElements-1)
+		{
+			int N = elementDoFs.size();
+			std::vector<double> K(N*N);
+			for (int a=0; a<N; ++a)
+				for (int b=0; b<N; ++b)
+					K[a*N + b] = this->a(currentElement, b, a, a_uPrev);
+
+			this->apply_boundaryConditions(elementCounter, elementDoFs, K.data(), loadVector, a_uPrev);
+		}
+	}
+
+	f_pointCoefficient epsilon = [this](Element*, const int&) -> double
+	{
+		return this->epsilon;
+	};
+
+	// a_k counts the points of the Mass rule, which need not be the
+	//  element's usual one.
+	f_pointCoefficient f_ = [this, &a_uPrev, elements](Element* a_element, const int &a_k) -> double
+	{
+		int elementNo = a_element->get_elementNo();
+		const int* elementDoFs = elements->get_rawElementDoFs(elementNo);
+		const basis::Tabulation &tabulation = a_element->get_elementBasis(quadrature::Mass);
+
+		double u_value = 0;
+		for (int j=0; j<elements->get_noElementDoFs(elementNo); ++j)
+			u_value += a_uPrev[elementDoFs[j]] * tabulation.get_row(j, 0)[a_k];
+
+		double x_value = a_element->mapLocalToGlobal(a_element->get_elementQuadrature(quadrature::Mass).points[a_k]);
+
+		return this->f_(x_value, u_value);
+	};
+
+	a_stiffnessOperator.set_coefficients(elements, epsilon, f_);
+
+	std::vector<double> update = this->solve_linearSystem(a_stiffnessOperator, loadVector, {}, a_cgTolerance, a_statistics);
+
+	for (int i=0; i<a_uNext.size(); ++i)
+		a_uNext[i] = a_uPrev[i] - update[i];
+
+	this->apply_dirichletValues(a_uNext);
+
+	a_difference = common::l2Norm(a_uNext, a_uPrev);
+}
+
+/******************************************************************************
+ * __Solve__
+ * 
+ * @details 	Newton's method from the given initial guess.
+ * 
+ * @param[in] a_cgTolerance 		The tolerance of each linear solve.
+ * @param[in] a_NewtonTolerance 	The largest change allowed in the last
+ * 									 iteration.
+ * @param[in] a_u0 					The initial guess in the NodesFirst
+ * 									 numbering; it may stop after the nodes,
+ * 									 with the rest taken to be zero.
+ ******************************************************************************/
 void Solution_nonlinear::Solve(const double &a_cgTolerance, const double &a_NewtonTolerance, const std::vector<double> &a_u0)
 {
 	// Consecutive values of x.
 	std::vector<double> uPrev;
-	std::vector<double> uNext = a_u0;
+	std::vector<double> uNext(this->mesh->elements->get_DoF(), 0);
+	for (int i=0; i<a_u0.size(); ++i)
+		uNext[this->mesh->elements->get_DoFNumber(i)] = a_u0[i];
+	this->apply_dirichletValues(uNext);
 
     // Difference between subsequent terms.
     double difference;
@@ -523,13 +610,56 @@ void Solution_nonlinear::Solve(const double &a_cgTolerance, const double &a_Newt
     // Loop counter.
     int k = 0;
 
+	// Totals over the linear solves of every iteration.
+	linearSystems::Statistics statistics;
+	this->solverStatistics = {0, 0, 0, 0, linearSystems::Converged, 0};
+	auto add_statistics = [this](const linearSystems::Statistics &a_statistics)
+	{
+		this->solverStatistics.noIterations  += a_statistics.noIterations;
+		this->solverStatistics.residualNorm   = a_statistics.residualNorm;
+		this->solverStatistics.setupTime     += a_statistics.setupTime;
+		this->solverStatistics.solveTime     += a_statistics.solveTime;
+		this->solverStatistics.stoppingReason = a_statistics.stoppingReason;
+		this->solverStatistics.errorEstimate  = a_statistics.errorEstimate;
+	};
+
+	// Matrix-free Newton only refreshes the coefficients each iteration.
+	if (this->matrixFree)
+	{
+		Operator_matrixFree stiffnessOperator(this->mesh->elements, false);
+		this->apply_boundaryConditions(stiffnessOperator);
+
+		do
+		{
+			uPrev = uNext;
+			this->Solve_single(stiffnessOperator, a_cgTolerance, uPrev, uNext, difference, statistics);
+			++k;
+
+			add_statistics(statistics);
+
+		} while(difference >= a_NewtonTolerance);
+
+		this->solution = uNext;
+		return;
+	}
+
+	// The sparsity pattern is the same for every iteration.
+	int n = this->mesh->elements->get_DoF();
+	std::vector<int> xs;
+	std::vector<int> ys;
+	this->mesh->elements->get_assemblyPattern(xs, ys);
+
+	Matrix_sparse<double> stiffnessMatrix(n, n, xs, ys);
+
 	// Iterates until the tolerance is small enough.
 	do
 	{
 		uPrev = uNext;
-		this->Solve_single(a_cgTolerance, a_NewtonTolerance, uPrev, uNext, difference);
+		this->Solve_single(stiffnessMatrix, a_cgTolerance, a_NewtonTolerance, uPrev, uNext, difference, statistics);
         ++k;
 
+		add_statistics(statistics);
+
 	} while(difference >= a_NewtonTolerance);
 
 	this->solution = uNext;
@@ -581,16 +711,16 @@ double Solution_nonlinear::compute_epsilonNormF(const std::vector<double> &a_u)
 
 		double Jacobian = currentElement->get_Jacobian();
 
-		std::vector<double> coordinates;
-		std::vector<double> weights;
-		currentElement->get_elementQuadrature(coordinates, weights);
+		const quadrature::Rule &rule = currentElement->get_elementQuadrature();
+		const double* coordinates = rule.points;
+		const double* weights     = rule.weights;
 
-		for (int j=0; j<coordinates.size(); ++j)
+		for (int j=0; j<rule.noPoints; ++j)
 		{
-			double uh   = compute_uh(i, coordinates[j], 0, a_u);
-			double uh_1 = compute_uh(i, coordinates[j], 1, a_u);
-			double uh_2 = compute_uh(i, coordinates[j], 2, a_u);
-			double uh_3 = compute_uh(i, coordinates[j], 3, a_u);
+			double uh   = compute_uhQuadrature(i, j, 0, a_u);
+			double uh_1 = compute_uhQuadrature(i, j, 1, a_u);
+			double uh_2 = compute_uhQuadrature(i, j, 2, a_u);
+			double uh_3 = compute_uhQuadrature(i, j, 3, a_u);
 			double f    = this->f(coordinates[j], uh);
 
 			double F   = -this->epsilon*uh_2 + f;
@@ -604,6 +734,24 @@ double Solution_nonlinear::compute_epsilonNormF(const std::vector<double> &a_u)
 	return sqrt(norm);
 }
 
+bool Solution_nonlinear::get_matrixFree() const
+{
+	return this->matrixFree;
+}
+
+/******************************************************************************
+ * __set_matrixFree__
+ * 
+ * @details 	Chooses whether Newton applies the Jacobian element by element
+ * 				instead of assembling it every iteration.
+ * 
+ * @param[in] a_matrixFree 	Whether to solve matrix-free.
+ ******************************************************************************/
+void Solution_nonlinear::set_matrixFree(const bool &a_matrixFree)
+{
+	this->matrixFree = a_matrixFree;
+}
+
 f_double2 Solution_nonlinear::get_f() const
 {
 	return this->f;
@@ -643,15 +791,15 @@ double Solution_nonlinear::compute_energyNormDifference2(f_double const &a_u, f_
 		Element* currentElement = (*(this->mesh->elements))[i];
 
 		// Retrieves quadrature information.
-		std::vector<double> coordinates;
-		std::vector<double> weights;
-		currentElement->get_elementQuadrature(coordinates, weights);
+		const quadrature::Rule &rule = currentElement->get_elementQuadrature();
+		const double* coordinates = rule.points;
+		const double* weights     = rule.weights;
 
-		for (int j=0; j<coordinates.size(); ++j)
+		for (int j=0; j<rule.noPoints; ++j)
 		{
 			// Actual and approximate solution at coordinates.
-			double uh   = compute_uh(i, coordinates[j], 0);
-			double uh_1 = compute_uh(i, coordinates[j], 1);
+			double uh   = compute_uhQuadrature(i, j, 0);
+			double uh_1 = compute_uhQuadrature(i, j, 1);
 			double u    = a_u  (currentElement->mapLocalToGlobal(coordinates[j]));
 			double u_1  = a_u_1(currentElement->mapLocalToGlobal(coordinates[j]));
 
@@ -676,24 +824,24 @@ double Solution_nonlinear::compute_errorIndicator(const double &a_i, const std::
 	// Gets element and its properties.
 	Element* currentElement = (*(this->mesh->elements))[a_i];
 	int P = currentElement->get_polynomialDegree();
-	double leftNode  = currentElement->get_nodeCoordinates()[0];
-	double rightNode = currentElement->get_nodeCoordinates()[1];
+	double leftNode  = currentElement->get_leftNode();
+	double rightNode = currentElement->get_rightNode();
 	double Jacobian  = currentElement->get_Jacobian();
 
 	// Calculates L2 norm on element with weight and residual.
 	double etaNorm2 = 0;
 	double deltaNorm2 = 0;
-	std::vector<double> quadratureCoordinates;
-	std::vector<double> quadratureWeights;
-	currentElement->get_elementQuadrature(quadratureCoordinates, quadratureWeights);
+	const quadrature::Rule &rule = currentElement->get_elementQuadrature();
+	const double* quadratureCoordinates = rule.points;
+	const double* quadratureWeights     = rule.weights;
 
 	// Loops over quadrature coordinates and weights.
-	for (int j=0; j<quadratureCoordinates.size(); ++j)
+	for (int j=0; j<rule.noPoints; ++j)
 	{
-		double uh0   = compute_uh(a_i, quadratureCoordinates[j], 0, a_u0);
-		double uh1   = compute_uh(a_i, quadratureCoordinates[j], 0, a_u1);
-		double uh0_2 = compute_uh(a_i, quadratureCoordinates[j], 2, a_u0);
-		double uh1_2 = compute_uh(a_i, quadratureCoordinates[j], 2, a_u1);
+		double uh0   = compute_uhQuadrature(a_i, j, 0, a_u0);
+		double uh1   = compute_uhQuadrature(a_i, j, 0, a_u1);
+		double uh0_2 = compute_uhQuadrature(a_i, j, 2, a_u0);
+		double uh1_2 = compute_uhQuadrature(a_i, j, 2, a_u1);
 		double residual = compute_modifiedResidual(uh0, uh1, uh0_2, uh1_2, a_damping, currentElement->mapLocalToGlobal(quadratureCoordinates[j]));
 
 		double x = currentElement->mapLocalToGlobal(quadratureCoordinates[j]);
@@ -702,10 +850,10 @@ double Solution_nonlinear::compute_errorIndicator(const double &a_i, const std::
 		etaNorm2 += pow(sqrt(weight)*residual, 2)*quadratureWeights[j]*Jacobian;
 	}
 
-	for (int j=0; j<quadratureCoordinates.size(); ++j)
+	for (int j=0; j<rule.noPoints; ++j)
 	{
-		double uh0 = compute_uh(a_i, quadratureCoordinates[j], 0, a_u0);
-		double uh1 = compute_uh(a_i, quadratureCoordinates[j], 0, a_u1);
+		double uh0 = compute_uhQuadrature(a_i, j, 0, a_u0);
+		double uh1 = compute_uhQuadrature(a_i, j, 0, a_u1);
 
 		double modified_f = this->modified_f(uh0, uh1, a_damping, currentElement->mapLocalToGlobal(quadratureCoordinates[j]));
 		double modified_u = this->modified_u(uh0, uh1, a_damping);
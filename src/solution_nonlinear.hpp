@@ -8,6 +8,8 @@
 #define CLASS_SOLUTIONNONLINEAR
 
 #include "common.hpp"
+#include "matrix_sparse.hpp"
+#include "operator_matrixFree.hpp"
 #include "solution.hpp"
 #include <vector>
 
@@ -18,10 +20,11 @@ class Solution_nonlinear : public Solution
 		f_double2 f;
 		f_double2 f_;
 		double epsilon;
+		bool matrixFree;
 
 		// Computes stiffness and load vector terms.
-		double a(Element* currentElement, f_double &basis1, f_double &basis2, f_double &basis1_, f_double &basis2_, const std::vector<double> &u) const;
-		double l(Element* currentElement, f_double &basis, f_double &basis_, const std::vector<double> &u) const;
+		double a(Element* currentElement, const int &a_basis1, const int &a_basis2, const std::vector<double> &u) const;
+		double l(Element* currentElement, const int &a_basis, const std::vector<double> &u) const;
 
 		// Computers.
 		double compute_residual(const double &a_uh, const double &a_uh_2, const double &a_x) const;
@@ -41,7 +44,8 @@ class Solution_nonlinear : public Solution
 		// Solvers.
 		void Solve(const double &a_cgTolerance);
 		void Solve(const double &a_cgTolerance, const double &a_NewtonTolerance, const std::vector<double> &a_u0);
-		void Solve_single(const double &a_cgTolerance, const double &a_NewtonTolerance, const std::vector<double> &a_uPrev, std::vector<double> &a_uNext, double &a_difference) const;
+		void Solve_single(Matrix_sparse<double> &a_stiffnessMatrix, const double &a_cgTolerance, const double &a_NewtonTolerance, const std::vector<double> &a_uPrev, std::vector<double> &a_uNext, double &a_difference, linearSystems::Statistics &a_statistics) const;
+		void Solve_single(Operator_matrixFree &a_stiffnessOperator, const double &a_cgTolerance, const std::vector<double> &a_uPrev, std::vector<double> &a_uNext, double &a_difference, linearSystems::Statistics &a_statistics) const;
 
 		// Computers.
 		double compute_energyNormDifference2(f_double const &a_u, f_double const &a_u_1) const;
@@ -55,6 +59,10 @@ class Solution_nonlinear : public Solution
 		f_double2 get_f() const;
 		f_double2 get_f_() const;
 		double get_epsilon() const;
+		bool get_matrixFree() const;
+
+		// Setters.
+		void set_matrixFree(const bool &a_matrixFree);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "../src/element.hpp"
+#include "../src/kernels.hpp"
+#include "../src/matrix_banded.hpp"
+#include "../src/matrix_sparse.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// Times a matrix-vector product, in microseconds per product. The best of a
+//  few trials is taken to filter out noise from the rest of the machine.
+template<class F>
+double time(F a_product, const int &a_noRepeats)
+{
+	double best = INFINITY;
+
+	for (int trial=0; trial<5; ++trial)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (int k=0; k<a_noRepeats; ++k)
+			a_product();
+		auto end = std::chrono::steady_clock::now();
+
+		best = std::min(best, std::chrono::duration<double, std::micro>(end - start).count()/a_noRepeats);
+	}
+
+	return best;
+}
+
+double maxDifference(const std::vector<double> &a_v1, const std::vector<double> &a_v2)
+{
+	double difference = 0;
+	for (int i=0; i<a_v1.size(); ++i)
+		difference = std::max(difference, std::abs(a_v1[i] - a_v2[i]));
+
+	return difference;
+}
+
+int main()
+{
+	int n = 2000;
+	int noRepeats = 200;
+	kernels::InstructionSet best = kernels::get_supportedInstructionSet();
+
+	std::cout << "Instruction set: " << (best == kernels::AVX512 ? "AVX-512" : best == kernels::AVX2 ? "AVX2" : "scalar") << std::endl;
+	std::cout << std::setw(8) << "p" << std::setw(14) << "layout"
+	          << std::setw(14) << "scalar (us)" << std::setw(14) << "vector (us)"
+	          << std::setw(10) << "speedup" << std::setw(14) << "difference" << std::endl;
+
+	for (int p : {1, 2, 4, 8, 16})
+	{
+		// The global matrix of a uniform degree p mesh.
+		std::vector<double> nodeCoordinates(n+1);
+		for (int i=0; i<=n; ++i)
+			nodeCoordinates[i] = double(i)/n;
+
+		Elements elements(n, nodeCoordinates, std::vector<int>(n, p));
+		std::vector<int> xs;
+		std::vector<int> ys;
+		elements.get_assemblyPattern(xs, ys);
+
+		int noDoFs = elements.get_DoF();
+		Matrix_sparse<double> matrix(noDoFs, noDoFs, xs, ys);
+
+		std::vector<double> values(xs.size());
+		for (int k=0; k<values.size(); ++k)
+			values[k] = sin(k);
+		matrix.set_values(values);
+
+		// A symmetric banded matrix of the same bandwidth as the
+		//  Interleaved numbering gives.
+		Matrix_banded<double> banded(noDoFs, p);
+		for (int j=0; j<noDoFs; ++j)
+			for (int i=j; i<=std::min(noDoFs-1, j+p); ++i)
+				banded.set(i, j, cos(i+j));
+
+		std::vector<double> x(noDoFs);
+		for (int i=0; i<noDoFs; ++i)
+			x[i] = 1.0/(i+1);
+
+		std::vector<double> yScalar(noDoFs);
+		std::vector<double> yVector(noDoFs);
+
+		// CSR.
+		kernels::set_instructionSet(kernels::Scalar);
+		double scalarTime = time([&]{ matrix.multiply(x, yScalar); }, noRepeats);
+		kernels::set_instructionSet(best);
+		double vectorTime = time([&]{ matrix.multiply(x, yVector); }, noRepeats);
+
+		std::cout << std::setw(8) << p << std::setw(14) << "CSR"
+		          << std::setw(14) << scalarTime << std::setw(14) << vectorTime
+		          << std::setw(10) << scalarTime/vectorTime << std::setw(14) << maxDifference(yScalar, yVector) << std::endl;
+
+		// Banded.
+		kernels::set_instructionSet(kernels::Scalar);
+		scalarTime = time([&]{ banded.multiply(x, yScalar); }, noRepeats);
+		kernels::set_instructionSet(best);
+		vectorTime = time([&]{ banded.multiply(x, yVector); }, noRepeats);
+
+		std::cout << std::setw(8) << p << std::setw(14) << "banded"
+		          << std::setw(14) << scalarTime << std::setw(14) << vectorTime
+		          << std::setw(10) << scalarTime/vectorTime << std::setw(14) << maxDifference(yScalar, yVector) << std::endl;
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "../src/element.hpp"
+#include "../src/linearSystems.hpp"
+#include "../src/mesh.hpp"
+#include "../src/refinement.hpp"
+#include "../src/solution.hpp"
+#include "../src/solution_linear.hpp"
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+double f(double x)
+{
+	return sin(40*x)*exp(x);
+}
+
+int main()
+{
+	double epsilon = 1e-2;
+	int n = 4;
+	int noRefinements = 12;
+
+	std::vector<linearSystems::Preconditioning> preconditionings = {linearSystems::Jacobi, linearSystems::IncompleteCholesky, linearSystems::Multigrid, linearSystems::Multigrid, linearSystems::Multigrid};
+	std::vector<std::string> names = {"Jacobi", "IC(0)", "V-cycle", "W-cycle", "V-cycles"};
+
+	std::cout << std::setw(4) << "p" << std::setw(16) << "preconditioner" << std::setw(10) << "DoF" << std::setw(8) << "levels"
+	          << std::setw(12) << "iterations" << std::setw(14) << "setup (ms)" << std::setw(14) << "solve (ms)" << std::endl;
+
+	for (int p : {1, 2})
+		for (int i=0; i<preconditionings.size(); ++i)
+		{
+			// Uniform refinement from a coarse mesh, keeping the meshes as levels.
+			std::vector<double> nodeCoordinates(n+1);
+			for (int j=0; j<=n; ++j)
+				nodeCoordinates[j] = double(j)/n;
+
+			Mesh* myMesh = new Mesh(new Elements(n, nodeCoordinates, std::vector<int>(n, p)));
+			myMesh->elements->set_DoFOrdering(Elements::Interleaved);
+			Solution* mySolution = new Solution_linear(myMesh, f, epsilon, 1);
+
+			mySolution->set_preconditioning(preconditionings[i]);
+			mySolution->set_multigridCycle(names[i] == "W-cycle" ? linearSystems::WCycle : linearSystems::VCycle);
+			mySolution->set_multigridSolver(names[i] == "V-cycles");
+
+			// Cold solves to a relative tolerance, so that the iterations are
+			//  the preconditioner's alone.
+			linearSystems::StoppingCriteria criteria;
+			criteria.relativeTolerance = 1e-10;
+			mySolution->set_stoppingCriteria(criteria);
+
+			for (int k=0; k<=noRefinements; ++k)
+			{
+				mySolution->Solve(0);
+
+				const linearSystems::Statistics &statistics = mySolution->get_solverStatistics();
+				if (k >= noRefinements-4)
+					std::cout << std::setw(4) << p << std::setw(16) << names[i] << std::setw(10) << myMesh->elements->get_DoF()
+					          << std::setw(8) << mySolution->get_noMultigridLevels() << std::setw(12) << statistics.noIterations
+					          << std::setw(14) << 1000*statistics.setupTime << std::setw(14) << 1000*statistics.solveTime << std::endl;
+
+				if (k == noRefinements)
+					break;
+
+				Mesh*     newMesh;
+				Solution* newSolution;
+				refinement::refine_h(myMesh, &newMesh, mySolution, &newSolution, std::vector<double>(myMesh->get_noElements(), 1));
+				newSolution->set_initialGuess({});
+
+				delete mySolution;
+				delete myMesh;
+				myMesh     = newMesh;
+				mySolution = newSolution;
+			}
+
+			delete mySolution;
+			delete myMesh;
+		}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "../src/element.hpp"
+#include "../src/linearSystems.hpp"
+#include "../src/mesh.hpp"
+#include "../src/solution.hpp"
+#include "../src/solution_linear.hpp"
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+double one(double x)
+{
+	return 1;
+}
+
+int main()
+{
+	// A boundary layer problem on meshes graded towards both ends.
+	double epsilon = 1e-3;
+	int n = 64;
+
+	std::vector<double> nodeCoordinates(n+1);
+	for (int i=0; i<=n; ++i)
+		nodeCoordinates[i] = (1 - cos(M_PI*i/n))/2;
+
+	std::vector<linearSystems::Preconditioning> preconditionings = {linearSystems::None, linearSystems::Jacobi, linearSystems::BlockJacobi, linearSystems::IncompleteCholesky};
+	std::vector<std::string> names = {"none", "Jacobi", "block Jacobi", "IC(0)"};
+
+	// The direct solvers, for comparison.
+	preconditionings.push_back(linearSystems::None);
+	names.push_back("banded LDL^T");
+	preconditionings.push_back(linearSystems::None);
+	names.push_back("float LDL^T");
+	preconditionings.push_back(linearSystems::None);
+	names.push_back("condensed");
+
+	std::vector<Elements::DoFOrdering> orderings = {Elements::NodesFirst, Elements::Interleaved};
+	std::vector<std::string> orderingNames = {"nodes first", "interleaved"};
+
+	std::cout << std::setw(4) << "p" << std::setw(14) << "ordering" << std::setw(16) << "preconditioner"
+	          << std::setw(12) << "iterations" << std::setw(14) << "setup (ms)" << std::setw(14) << "solve (ms)" << std::endl;
+
+	for (int p : {1, 2, 4, 8})
+		for (int k=0; k<orderings.size(); ++k)
+			for (int i=0; i<preconditionings.size(); ++i)
+			{
+				Mesh* myMesh = new Mesh(new Elements(n, nodeCoordinates, std::vector<int>(n, p)));
+				myMesh->elements->set_DoFOrdering(orderings[k]);
+				Solution_linear* mySolution = new Solution_linear(myMesh, one, epsilon, 1);
+
+				mySolution->set_preconditioning(preconditionings[i]);
+				mySolution->set_directSolver(names[i] == "banded LDL^T" || names[i] == "float LDL^T");
+				mySolution->set_mixedPrecision(names[i] == "float LDL^T");
+				mySolution->set_staticCondensation(names[i] == "condensed");
+				mySolution->Solve(1e-12);
+
+				const linearSystems::Statistics &statistics = mySolution->get_solverStatistics();
+				std::cout << std::setw(4) << p << std::setw(14) << orderingNames[k] << std::setw(16) << names[i]
+				          << std::setw(12) << statistics.noIterations
+				          << std::setw(14) << 1000*statistics.setupTime << std::setw(14) << 1000*statistics.solveTime << std::endl;
+
+				delete mySolution;
+				delete myMesh;
+			}
+
+	return 0;
+}
\ No newline at end of file
@@ -44,7 +44,7 @@ int main()
 {
 	// Sets up problem.
 	Mesh*            myMesh     = new Mesh(4);
-	Solution_linear* mySolution = new Solution_linear(myMesh, f, 1, one);
+	Solution_linear* mySolution = new Solution_linear(myMesh, f, 1, 1);
 
 	// Adaptivity variables.
 	Mesh*            myNewMesh;
@@ -51,7 +51,7 @@ int main()
 {
 	// Sets up problem.
 	Mesh*            myMesh     = new Mesh(6);
-	Solution_linear* mySolution = new Solution_linear(myMesh, f, 1, one);
+	Solution_linear* mySolution = new Solution_linear(myMesh, f, 1, 1);
 
 	// Adaptivity variables.
 	Mesh*            myNewMesh;
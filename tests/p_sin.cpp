@@ -43,7 +43,7 @@ int main()
 {
 	// Sets up problem.
 	Mesh*            myMesh     = new Mesh(4);
-	Solution_linear* mySolution = new Solution_linear(myMesh, pi2sin, 1, zero);
+	Solution_linear* mySolution = new Solution_linear(myMesh, pi2sin, 1, 0);
 
 	// Adaptivity variables.
 	Mesh*            myNewMesh;
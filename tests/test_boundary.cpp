@@ -42,7 +42,7 @@ int main()
 {
 	// Sets up problem.
 	Mesh*     myMesh     = new Mesh(4);
-	Solution_linear* mySolution = new Solution_linear(myMesh, one, 1e-3, one);
+	Solution_linear* mySolution = new Solution_linear(myMesh, one, 1e-3, 1);
 
 	// Solves the new problem, and then outputs solution and mesh to files.
 	mySolution->Solve(1e-15);
@@ -51,7 +51,7 @@ int main()
 {
 	// Sets up problem.
 	Mesh*            myMesh     = new Mesh(6);
-	Solution_linear* mySolution = new Solution_linear(myMesh, f, 1, one);
+	Solution_linear* mySolution = new Solution_linear(myMesh, f, 1, 1);
 
 	// Solves the new problem, and then outputs solution and mesh to files.
 	mySolution->Solve(1e-15);
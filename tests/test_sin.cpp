@@ -43,7 +43,7 @@ int main()
 {
 	// Sets up problem.
 	Mesh*            myMesh     = new Mesh(4);
-	Solution_linear* mySolution = new Solution_linear(myMesh, pi2sin, 1, zero);
+	Solution_linear* mySolution = new Solution_linear(myMesh, pi2sin, 1, 0);
 
 	// Solves the new problem, and then outputs solution and mesh to files.
 	mySolution->Solve(1e-15);